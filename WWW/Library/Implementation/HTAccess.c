@@ -66,6 +66,7 @@
 #include <LYexit.h>
 #include <LYStrings.h>
 #include <LYUtils.h>
+#include <LYShowInfo.h>
 #include <LYLeaks.h>
 
 /*
@@ -936,7 +937,10 @@ static BOOL HTLoadDocument(const char *full_address,	/* may include #fragment */
     if (ForcingNoCache) {
 	FREE(anchor->title);	/* ??? */
     }
+    HTStartTiming();
     status = HTLoad(address_to_load, anchor, format_out, sink);
+    HTFinishTiming(anchor, status);
+    LYShowDocumentMemory(anchor);
     CTRACE((tfp, "HTAccess:  status=%d\n", status));
 
     /*
@@ -338,10 +338,13 @@ HTChildAnchor *HTAnchor_findChildAndLink(HTParentAnchor *parent,	/* May not be 0
 		const char *relative_to = ((parent->inBASE && *href != '#')
 					   ? parent->content_base
 					   : parent->address);
+		HTParsedBase **base = ((relative_to == parent->address)
+				       ? &(parent->parsed_address)
+				       : &(parent->parsed_base));
 		DocAddress parsed_doc;
 
-		parsed_doc.address = HTParse(href, relative_to,
-					     PARSE_ALL_WITHOUT_ANCHOR);
+		parsed_doc.address = HTParseRelative(href, base, relative_to,
+						     PARSE_ALL_WITHOUT_ANCHOR);
 
 		parsed_doc.post_data = NULL;
 		parsed_doc.post_content_type = NULL;
@@ -792,6 +795,8 @@ static void HTParentAnchor_free(HTParentAnchor *me)
     FREE(me->content_language);
     FREE(me->content_encoding);
     FREE(me->content_base);
+    HTParseFreeBase(&(me->parsed_base));
+    HTParseFreeBase(&(me->parsed_address));
     FREE(me->content_disposition);
     FREE(me->content_location);
     FREE(me->content_md5);
@@ -839,6 +844,128 @@ void HTAnchor_clearSourceCache(HTParentAnchor *me)
 }
 #endif /* USE_SOURCE_CACHE */
 
+static long ParentAnchorMemory(HTParentAnchor *me)
+{
+    long result = (long) sizeof(HTParentAnchor);
+
+    result += (StrMemory(me->charset)
+	       + StrMemory(me->isIndexAction)
+	       + StrMemory(me->isIndexPrompt)
+	       + StrMemory(me->title)
+	       + StrMemory(me->physical)
+	       + StrMemory(me->post_content_type)
+	       + StrMemory(me->bookmark)
+	       + StrMemory(me->owner)
+	       + StrMemory(me->RevTitle)
+	       + StrMemory(me->citehost)
+	       + StrMemory(me->FileCache)
+	       + StrMemory(me->SugFname)
+	       + StrMemory(me->cache_control)
+	       + StrMemory(me->content_type_params)
+	       + StrMemory(me->content_type)
+	       + StrMemory(me->content_language)
+	       + StrMemory(me->content_encoding)
+	       + StrMemory(me->content_base)
+	       + StrMemory(me->content_disposition)
+	       + StrMemory(me->content_location)
+	       + StrMemory(me->content_md5)
+	       + StrMemory(me->message_id)
+	       + StrMemory(me->subject)
+	       + StrMemory(me->date)
+	       + StrMemory(me->expires)
+	       + StrMemory(me->last_modified)
+	       + StrMemory(me->ETag)
+	       + StrMemory(me->server));
+    if (me->post_data != 0)
+	result += BStrLen(me->post_data);
+#ifdef EXP_HTTP_HEADERS
+    result += me->http_headers.allocated;
+#endif
+    if (me->UCStages != 0)
+	result += (long) sizeof(UCAnchorInfo);
+    return result;
+}
+
+/*
+ * Estimate the memory used by the anchors, setting anchors to the number of
+ * parent anchors.  The unnamed child anchors are allocated in the pool of the
+ * document which contains them, and are counted with it.  The source cache is
+ * counted separately.
+ */
+long HTAnchor_memoryUsed(long *anchors)
+{
+    long result = 0;
+    int n;
+
+    *anchors = 0;
+    for (n = 0; n < HASH_SIZE; ++n) {
+	HTList *cur = &adult_table[n];
+	HTParentAnchor0 *me;
+
+	while ((me = (HTParentAnchor0 *) HTList_nextObject(cur)) != NULL) {
+	    ++(*anchors);
+	    result += (long) sizeof(HTParentAnchor0) + StrMemory(me->address);
+	    if (me->children) {
+		HTBTElement *ele;
+
+		for (ele = HTBTree_next(me->children, NULL);
+		     ele != NULL;
+		     ele = HTBTree_next(me->children, ele)) {
+		    HTChildAnchor *child = (HTChildAnchor *) HTBTree_object(ele);
+
+		    result += (long) (sizeof(HTBTElement) + sizeof(HTChildAnchor))
+			+ StrMemory(child->tag);
+		}
+	    }
+	    if (me->info != 0)
+		result += ParentAnchorMemory(me->info);
+	}
+    }
+    return result;
+}
+
+#ifdef USE_SOURCE_CACHE
+/*
+ * Return the memory used to cache the source of a document.
+ */
+long HTAnchor_sourceMemory(HTParentAnchor *me)
+{
+    long result = 0;
+    HTChunk *chunk;
+
+    if (me != 0) {
+	for (chunk = me->source_cache_chunk; chunk != 0; chunk = chunk->next) {
+	    result += (long) sizeof(HTChunk) + chunk->allocated;
+	}
+    }
+    return result;
+}
+
+/*
+ * Sum the memory used by the source cache, setting documents to the number of
+ * documents whose source is cached in memory.
+ */
+long HTAnchor_sourceCacheMemory(long *documents)
+{
+    long result = 0;
+    int n;
+
+    *documents = 0;
+    for (n = 0; n < HASH_SIZE; ++n) {
+	HTList *cur = &adult_table[n];
+	HTParentAnchor0 *me;
+
+	while ((me = (HTParentAnchor0 *) HTList_nextObject(cur)) != NULL) {
+	    if (me->info != 0 && me->info->source_cache_chunk != 0) {
+		++(*documents);
+		result += HTAnchor_sourceMemory(me->info);
+	    }
+	}
+    }
+    return result;
+}
+#endif /* USE_SOURCE_CACHE */
+
 /*	Data access functions
  *	---------------------
  */
@@ -26,6 +26,7 @@ typedef struct _HTParentAnchor HTParentAnchor;
 typedef struct _HTParentAnchor0 HTParentAnchor0;
 
 #include <HTFormat.h>
+#include <HTParse.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,22 @@ extern "C" {
 
 #define HASH_TYPE unsigned short
 
+    /*
+     *  The phases of loading a document, for timing (see HTAccess.c).
+     */
+    typedef enum {
+	tpDNS = 0,		/* looking up the host name */
+	tpConnect,		/* waiting for the connection */
+	tpTLS,			/* TLS handshake */
+	tpWait,			/* sending the request, waiting for the reply */
+	tpTransfer,		/* reading the reply */
+	tpRender,		/* parsing and formatting what was read */
+	tpOther,		/* anything else, e.g., building the request */
+	tpTotal			/* total time for the document */
+    } HTTimePhase;
+
+#define HT_TIME_PHASES ((int) tpTotal + 1)
+
     struct _HTParentAnchor0 {	/* One for adult_table,
 				 * generally not used outside HTAnchor.c */
 	/* Common part from the generic anchor structure */
@@ -109,6 +126,8 @@ extern "C" {
 	char *content_language;	/* Content-Language */
 	char *content_encoding;	/* Compression algorithm */
 	char *content_base;	/* Content-Base */
+	HTParsedBase *parsed_base;	/* ...for resolving links */
+	HTParsedBase *parsed_address;	/* address, likewise */
 	char *content_disposition;	/* Content-Disposition */
 	char *content_location;	/* Content-Location */
 	char *content_md5;	/* Content-MD5 */
@@ -123,6 +142,7 @@ extern "C" {
 	char *server;		/* Server */
 	UCAnchorInfo *UCStages;	/* chartrans stages */
 	HTList *imaps;		/* client side image maps */
+	double timings[HT_TIME_PHASES];		/* seconds spent loading */
     };
 
     typedef HTAtom HTLinkType;
@@ -205,8 +225,15 @@ extern "C" {
      */
     extern void HTAnchor_delete_links(HTParentAnchor *me);
 
+    /*
+     * Estimate the memory used by anchors, and by the source cache.
+     */
+    extern long HTAnchor_memoryUsed(long *anchors);
+
 #ifdef USE_SOURCE_CACHE
     extern void HTAnchor_clearSourceCache(HTParentAnchor *me);
+    extern long HTAnchor_sourceCacheMemory(long *documents);
+    extern long HTAnchor_sourceMemory(HTParentAnchor *me);
 #endif
 
     /* Data access functions
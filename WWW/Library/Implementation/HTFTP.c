@@ -4111,6 +4111,9 @@ int HTFTPLoad(const char *name,
 	    case cftBzip2:
 		StrAllocCopy(anchor->content_encoding, "x-bzip2");
 		break;
+	    case cftZstd:
+		StrAllocCopy(anchor->content_encoding, "x-zstd");
+		break;
 	    case cftNone:
 		break;
 	    }
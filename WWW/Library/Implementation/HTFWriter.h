@@ -16,6 +16,8 @@ extern "C" {
 #endif
     extern HTStream *HTFWriter_new(FILE *fp);
 
+    extern FILE *HTFWriter_file(HTStream *me);
+
     extern HTStream *HTSaveAndExecute(HTPresentation *pres,
 				      HTParentAnchor *anchor,	/* Not used */
 				      HTStream *sink);
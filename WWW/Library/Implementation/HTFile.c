@@ -50,7 +50,7 @@
 #include <stat.h>
 #endif /* VMS */
 
-#if defined (USE_ZLIB) || defined (USE_BZLIB)
+#if defined (USE_ZLIB) || defined (USE_BZLIB) || defined (USE_ZSTD)
 #include <GridText.h>
 #endif
 
@@ -1284,6 +1284,11 @@ CompressFileType HTCompressFileType(const char *filename,
 	    && StrChr(dots, ftype[-4]) != 0) {
 	    result = cftBzip2;
 	    ftype -= 4;
+	} else if ((len > 4)
+		   && !strcasecomp((ftype - 3), "zst")
+		   && StrChr(dots, ftype[-4]) != 0) {
+	    result = cftZstd;
+	    ftype -= 4;
 	} else if ((len > 3)
 		   && !strcasecomp((ftype - 2), "gz")
 		   && StrChr(dots, ftype[-3]) != 0) {
@@ -1333,6 +1338,9 @@ const char *HTCompressTypeToSuffix(CompressFileType method)
     case cftDeflate:
 	result = ".zz";
 	break;
+    case cftZstd:
+	result = ".zst";
+	break;
     }
     return result;
 }
@@ -1361,6 +1369,9 @@ const char *HTCompressTypeToEncoding(CompressFileType method)
     case cftDeflate:
 	result = "deflate";
 	break;
+    case cftZstd:
+	result = "zstd";
+	break;
     }
     return result;
 }
@@ -1371,7 +1382,7 @@ const char *HTCompressTypeToEncoding(CompressFileType method)
  *	gzip
  *	compress
  *	deflate
- * as well as "identity" (but that does nothing).
+ * as well as "identity" (but that does nothing).  RFC 8478 adds "zstd".
  */
 CompressFileType HTEncodingToCompressType(const char *coding)
 {
@@ -1391,6 +1402,9 @@ CompressFileType HTEncodingToCompressType(const char *coding)
     } else if (!strcasecomp(coding, "deflate") ||
 	       !strcasecomp(coding, "x-deflate")) {
 	result = cftDeflate;
+    } else if (!strcasecomp(coding, "zstd") ||
+	       !strcasecomp(coding, "x-zstd")) {
+	result = cftZstd;
     }
     return result;
 }
@@ -1410,6 +1424,9 @@ CompressFileType HTContentTypeToCompressType(const char *ct)
     } else if (!strncasecomp(ct, "application/bzip2", 17) ||
 	       !strncasecomp(ct, "application/x-bzip2", 19)) {
 	method = cftBzip2;
+    } else if (!strncasecomp(ct, "application/zstd", 16) ||
+	       !strncasecomp(ct, "application/x-zstd", 18)) {
+	method = cftZstd;
     }
     return method;
 }
@@ -2318,7 +2335,7 @@ int HTStat(const char *filename,
 }
 #endif
 
-#if defined(USE_ZLIB) || defined(USE_BZLIB)
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
 static BOOL sniffStream(FILE *fp, char *buffer, size_t needed)
 {
     long offset = ftell(fp);
@@ -2408,6 +2425,23 @@ static BOOL isBzip2Stream(FILE *fp)
 }
 #endif
 
+#ifdef USE_ZSTD
+static BOOL isZstdStream(FILE *fp)
+{
+    char buffer[4];
+    BOOL result;
+
+    if (sniffStream(fp, buffer, sizeof(buffer))
+	&& !MemCmp(buffer, "\050\265\057\375", sizeof(buffer))) {
+	result = TRUE;
+    } else {
+	CTRACE((tfp, "not a zstd-stream\n"));
+	result = FALSE;
+    }
+    return result;
+}
+#endif
+
 #ifdef VMS
 #define FOPEN_MODE(bin) "r", "shr=put", "shr=upd"
 #define DOT_STRING "._-"	/* FIXME: should we check if suffix is after ']' or ':' ? */
@@ -2434,7 +2468,10 @@ static int decompressAndParse(HTParentAnchor *anchor,
 #ifdef USE_BZLIB
     BZFILE *bzfp = 0;
 #endif /* USE_ZLIB */
-#if defined(USE_ZLIB) || defined(USE_BZLIB)
+#ifdef USE_ZSTD
+    FILE *zsfp = 0;
+#endif /* USE_ZSTD */
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
     CompressFileType internal_decompress = cftNone;
     BOOL failed_decompress = NO;
 #endif
@@ -2492,7 +2529,7 @@ static int decompressAndParse(HTParentAnchor *anchor,
 	     * this is a compressed file, no need to look at the filename
 	     * again.  - kw
 	     */
-#if defined(USE_ZLIB) || defined(USE_BZLIB)
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
 	    CompressFileType method = HTEncodingToCompressType(HTAtom_name(myEncoding));
 #endif
 
@@ -2532,6 +2569,18 @@ static int decompressAndParse(HTParentAnchor *anchor,
 		internal_decompress = cftBzip2;
 	    } else
 #endif /* USE_BZLIB */
+#ifdef USE_ZSTD
+	    if (isDOWNLOAD(cftZstd)) {
+		if (isZstdStream(fp)) {
+		    zsfp = fp;
+		    fp = 0;
+
+		    CTRACE((tfp, "HTLoadFile: zsopen of `%s' gives %p\n",
+			    localname, (void *) zsfp));
+		}
+		internal_decompress = cftZstd;
+	    } else
+#endif /* USE_ZSTD */
 	    {
 		StrAllocCopy(anchor->content_type, format->name);
 		StrAllocCopy(anchor->content_encoding, HTAtom_name(myEncoding));
@@ -2610,11 +2659,28 @@ static int decompressAndParse(HTParentAnchor *anchor,
 		format = HTAtom_for("www/compressed");
 #endif /* USE_BZLIB */
 		break;
+	    case cftZstd:
+		StrAllocCopy(anchor->content_encoding, "x-zstd");
+#ifdef USE_ZSTD
+		if (strcmp(format_out->name, "www/download") != 0) {
+		    if (isZstdStream(fp)) {
+			zsfp = fp;
+			fp = 0;
+
+			CTRACE((tfp, "HTLoadFile: zsopen of `%s' gives %p\n",
+				localname, (void *) zsfp));
+		    }
+		    internal_decompress = cftZstd;
+		}
+#else /* USE_ZSTD */
+		format = HTAtom_for("www/compressed");
+#endif /* USE_ZSTD */
+		break;
 	    case cftNone:
 		break;
 	    }
 	}
-#if defined(USE_ZLIB) || defined(USE_BZLIB)
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
 	if (internal_decompress != cftNone) {
 	    switch (internal_decompress) {
 #ifdef USE_ZLIB
@@ -2630,6 +2696,11 @@ static int decompressAndParse(HTParentAnchor *anchor,
 	    case cftBzip2:
 		failed_decompress = (BOOLEAN) (bzfp == NULL);
 		break;
+#endif
+#ifdef USE_ZSTD
+	    case cftZstd:
+		failed_decompress = (BOOLEAN) (zsfp == NULL);
+		break;
 #endif
 	    default:
 		failed_decompress = YES;
@@ -2677,10 +2748,16 @@ static int decompressAndParse(HTParentAnchor *anchor,
 		    *statusp = HTParseZzFile(format, format_out,
 					     anchor,
 					     zzfp, sink);
+#endif
+#ifdef USE_ZSTD
+		if (zsfp)
+		    *statusp = HTParseZstdFile(format, format_out,
+					       anchor,
+					       zsfp, sink);
 #endif
 	    }
 	} else
-#endif /* USE_ZLIB || USE_BZLIB */
+#endif /* USE_ZLIB || USE_BZLIB || USE_ZSTD */
 	{
 	    *statusp = HTParseFile(format, format_out, anchor, fp, sink);
 	}
@@ -2950,6 +3027,9 @@ int HTLoadFile(const char *addr,
 			case cftBzip2:
 			    atomname = "application/x-bzip2";
 			    break;
+			case cftZstd:
+			    atomname = "application/zstd";
+			    break;
 			case cftNone:
 			    break;
 			}
@@ -3292,6 +3372,11 @@ void HTInitProgramPaths(BOOL init)
 	case ppZIP:
 	    path = ZIP_PATH;
 	    break;
+#endif
+#ifdef ZSTD_PATH
+	case ppZSTD:
+	    path = ZSTD_PATH;
+	    break;
 #endif
 	default:
 	    path = NULL;
@@ -213,6 +213,7 @@ extern "C" {
 	,cftGzip
 	,cftBzip2
 	,cftDeflate
+	,cftZstd
     } CompressFileType;
 
 /*
@@ -330,6 +331,7 @@ extern "C" {
 	,ppUUDECODE
 	,ppZCAT
 	,ppZIP
+	,ppZSTD
 	,pp_Last
     } ProgramPaths;
 
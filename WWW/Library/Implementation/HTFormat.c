@@ -43,6 +43,7 @@ static float HTMaxSecs = 1e10;	/* No effective limit */
 /*	Streams and structured streams which we use:
 */
 #include <HTFWriter.h>
+#include <HTMIME.h>
 #include <HTPlain.h>
 #include <SGML.h>
 #include <HTMLGen.h>
@@ -59,11 +60,43 @@ static float HTMaxSecs = 1e10;	/* No effective limit */
 
 BOOL HTOutputSource = NO;	/* Flag: shortcut parser to stdout */
 
-/* this version used by the NetToText stream */
+#if defined(HAVE_SPLICE) && !defined(NOT_ASCII)
+#define USE_SPLICE 1
+#define SPLICE_SIZE 65536	/* what a pipe holds, on Linux */
+#endif
+
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
+#include <HTFile.h>
+#define USE_DECODER 1
+#endif
+
+#if defined(USE_SOURCE_CACHE) && defined(HAVE_MMAP)
+#include <sys/mman.h>
+#define USE_MAPPED_CACHE 1
+#define MAPPED_BLOCK_SIZE 65536	/* how much to pass down at a time */
+#endif
+
+/* this version used by the NetToText and Decoder streams */
 struct _HTStream {
     const HTStreamClass *isa;
     BOOL had_cr;
     HTStream *sink;
+#ifdef USE_DECODER
+    CompressFileType method;
+    BOOL ready;			/* decompressor is initialized */
+    BOOL done;			/* ignore anything after error/end */
+#ifdef USE_ZLIB
+    z_stream zs;
+    char head[2];		/* used to check for a zlib header */
+    int head_len;
+#endif
+#ifdef USE_BZLIB
+    bz_stream bz;
+#endif
+#ifdef USE_ZSTD
+    ZSTD_DStream *zds;
+#endif
+#endif				/* USE_DECODER */
 };
 
 /*	Presentation methods
@@ -695,6 +728,25 @@ void HTFinishDisplayPartial(void)
 #endif /* DISP_PARTIAL */
 }
 
+/*	Find the file which a stream writes to
+ *	--------------------------------------
+ *
+ *	This is used to splice downloads directly from the socket to the file.
+ */
+int HTStreamFileno(HTStream *sink)
+{
+    HTStream *target;
+    FILE *fp;
+
+    if ((target = HTMIMETarget(sink)) != 0)
+	sink = target;
+    if ((fp = HTFWriter_file(sink)) != 0
+	&& !isatty(fileno(fp))
+	&& fflush(fp) == 0)
+	return fileno(fp);
+    return -1;
+}
+
 /*	Push data from a socket down a stream
  *	-------------------------------------
  *
@@ -739,6 +791,10 @@ int HTCopy(HTParentAnchor *anchor,
     off_t total;
     int rv = 0;
 
+#ifdef USE_SPLICE
+    int splice_fd = -1;		/* file which the data is spliced to */
+#endif
+
     /*  Push the data down the stream
      */
     targetClass = *(sink->isa);	/* Copy pointers to procedures */
@@ -751,6 +807,7 @@ int HTCopy(HTParentAnchor *anchor,
     HTReadProgress(bytes, (off_t) 0);
     for (;;) {
 	int status;
+	BOOL spliced = NO;
 
 	if (LYCancelDownload) {
 	    LYCancelDownload = FALSE;
@@ -768,13 +825,32 @@ int HTCopy(HTParentAnchor *anchor,
 		rv = -1;
 	    goto finished;
 	}
+	HTSetTimePhase(tpTransfer);
+#ifdef USE_SPLICE
+	/*
+	 * Once the headers are parsed, a download which is saved as is can
+	 * be moved from the socket to its file without passing through here.
+	 */
+	if (splice_fd < 0 && handle == 0) {
+	    if ((splice_fd = HTStreamFileno(sink)) >= 0)
+		CTRACE((tfp, "HTCopy: splicing data to file %d\n", splice_fd));
+	}
+	if (splice_fd >= 0 && (limit == 0 || bytes < limit)) {
+	    off_t size = SPLICE_SIZE;
+
+	    if (limit > 0 && bytes > 0 && limit - bytes < size)
+		size = limit - bytes;
+	    status = HTDoSplice(file_number, splice_fd, (unsigned) size);
+	    spliced = YES;
+	} else
+#endif
 #ifdef USE_SSL
 	if (handle)
 	    status = SSL_read((SSL *) handle, input_buffer, INPUT_BUFFER_SIZE);
 	else
 	    status = NETREAD(file_number, input_buffer, INPUT_BUFFER_SIZE);
 #else
-	status = NETREAD(file_number, input_buffer, INPUT_BUFFER_SIZE);
+	    status = NETREAD(file_number, input_buffer, INPUT_BUFFER_SIZE);
 #endif /* USE_SSL */
 
 	if (status <= 0) {
@@ -869,8 +945,11 @@ int HTCopy(HTParentAnchor *anchor,
 	}
 #endif /* NOT_ASCII */
 
+	HTSetTimePhase(tpRender);
 	total = bytes + status;
-	if (limit == 0 || bytes == 0 || (total < limit)) {
+	if (spliced) {
+	    ;			/* already in the file */
+	} else if (limit == 0 || bytes == 0 || (total < limit)) {
 	    (*targetClass.put_block) (sink, input_buffer, status);
 	} else if (bytes < limit) {
 	    (*targetClass.put_block) (sink, input_buffer, (int) (limit - bytes));
@@ -893,6 +972,7 @@ int HTCopy(HTParentAnchor *anchor,
     rv = HT_LOADED;
 
   finished:
+    HTSetTimePhase(tpRender);
     HTFinishDisplayPartial();
     return (rv);
 }
@@ -932,9 +1012,11 @@ int HTFileCopy(FILE *fp, HTStream *sink)
      */
     HTReadProgress(bytes = 0, (off_t) 0);
     for (;;) {
+	HTSetTimePhase(tpTransfer);
 	status = (int) fread(input_buffer,
 			     (size_t) 1,
 			     (size_t) INPUT_BUFFER_SIZE, fp);
+	HTSetTimePhase(tpRender);
 	if (status == 0) {	/* EOF or error */
 	    if (ferror(fp) == 0) {
 		rv = HT_LOADED;
@@ -977,6 +1059,77 @@ int HTFileCopy(FILE *fp, HTStream *sink)
 }
 
 #ifdef USE_SOURCE_CACHE
+/*	Push data from a source-cache file down a stream
+ *	------------------------------------------------
+ *
+ *   This is like HTFileCopy, but if possible maps the file into memory and
+ *   passes it down the stream from there, letting the system page it in (and
+ *   out again) as needed rather than copying it through a buffer.  Lynx does
+ *   not change a source-cache file while it is being read, so the mapping
+ *   stays valid.
+ *
+ *  State of file and target stream on entry:
+ *			FILE* (fp) assumed open (at its beginning),
+ *			target (sink) assumed valid.
+ *
+ *  Return values:
+ *	as for HTFileCopy.
+ *
+ *  State of file and target stream on return:
+ *	always		fp still open, target stream still valid.
+ */
+static int HTMappedFileCopy(FILE *fp, HTStream *sink)
+{
+#ifdef USE_MAPPED_CACHE
+    HTStreamClass targetClass;
+    struct stat sb;
+    char *data;
+    size_t length;
+    off_t bytes;
+    int rv = HT_LOADED;
+
+    if (fstat(fileno(fp), &sb) != 0
+	|| !S_ISREG(sb.st_mode)
+	|| sb.st_size <= 0
+	|| (off_t) (length = (size_t) sb.st_size) != sb.st_size
+	|| (data = (char *) mmap(NULL, length, PROT_READ, MAP_SHARED,
+				 fileno(fp), (off_t) 0)) == MAP_FAILED) {
+	CTRACE((tfp, "HTMappedFileCopy: cannot map file, reading it\n"));
+	return HTFileCopy(fp, sink);
+    }
+#ifdef MADV_SEQUENTIAL
+    (void) madvise(data, length, MADV_SEQUENTIAL);
+#endif
+
+    targetClass = *(sink->isa);
+    HTSetTimePhase(tpRender);
+    HTReadProgress(bytes = 0, (off_t) 0);
+    while (bytes < sb.st_size) {
+	int block = (int) HTMIN(sb.st_size - bytes, MAPPED_BLOCK_SIZE);
+
+	(*targetClass.put_block) (sink, data + bytes, block);
+	bytes += block;
+	HTReadProgress(bytes, (off_t) 0);
+#ifdef DISP_PARTIAL
+	if (display_partial && bytes != sb.st_size)
+	    HTDisplayPartial();
+#endif
+
+	if (HTCheckForInterrupt()) {
+	    _HTProgress(TRANSFER_INTERRUPTED);
+	    rv = HT_INTERRUPTED;
+	    break;
+	}
+    }
+
+    (void) munmap(data, length);
+    HTFinishDisplayPartial();
+    return rv;
+#else
+    return HTFileCopy(fp, sink);
+#endif
+}
+
 /*	Push data from an HTChunk down a stream
  *	---------------------------------------
  *
@@ -1000,6 +1153,7 @@ int HTMemCopy(HTChunk *chunk, HTStream *sink)
     int rv = HT_OK;
 
     targetClass = *(sink->isa);
+    HTSetTimePhase(tpRender);
     HTReadProgress(bytes = 0, (off_t) 0);
     for (; chunk != NULL; chunk = chunk->next) {
 
@@ -1065,7 +1219,9 @@ static int HTGzFileCopy(gzFile gzfp, HTStream *sink)
      */
     HTReadProgress(bytes = 0, (off_t) 0);
     for (;;) {
+	HTSetTimePhase(tpTransfer);
 	status = gzread(gzfp, input_buffer, INPUT_BUFFER_SIZE);
+	HTSetTimePhase(tpRender);
 	if (status <= 0) {	/* EOF or error */
 	    if (status == 0) {
 		rv = HT_LOADED;
@@ -1271,7 +1427,9 @@ static int HTBzFileCopy(BZFILE * bzfp, HTStream *sink)
      */
     HTReadProgress(bytes = 0, (off_t) 0);
     for (;;) {
+	HTSetTimePhase(tpTransfer);
 	status = BZ2_bzread(bzfp, input_buffer, INPUT_BUFFER_SIZE);
+	HTSetTimePhase(tpRender);
 	if (status <= 0) {	/* EOF or error */
 	    if (status == 0) {
 		rv = HT_LOADED;
@@ -1414,34 +1572,16 @@ int HTParseSocket(HTFormat rep_in,
     /* Originally:  full: HT_LOADED;  partial: HT_INTERRUPTED;  no bytes: -1 */
 }
 
-/*	Parse a file given format and file pointer
- *
- *   This routine is responsible for creating and PRESENTING any
- *   graphic (or other) objects described by the file.
- *
- *   The file number given is assumed to be a TELNET stream ie containing
- *   CRLF at the end of lines which need to be stripped to \n for unix
- *   when the format is textual.
- *
- *  State of file and target stream on entry:
- *			FILE* (fp) assumed open,
- *			target (sink) usually NULL (will call stream stack).
- *
- *  Return values:
- *	-501		Stream stack failed (cannot present or convert).
- *	-1		Download cancelled.
- *	HT_NO_DATA	Error before any data read.
- *	HT_PARTIAL_CONTENT	Interruption or error after some data read.
- *	HT_LOADED	Normal end of file indication on reading.
- *
- *  State of file and target stream on return:
- *	always		fp still open; target freed, aborted, or NULL.
+/*
+ * Common part of HTParseFile and HTParseMappedFile, which differ only in how
+ * they copy the file to the stream.
  */
-int HTParseFile(HTFormat rep_in,
-		HTFormat format_out,
-		HTParentAnchor *anchor,
-		FILE *fp,
-		HTStream *sink)
+static int parse_file(HTFormat rep_in,
+		      HTFormat format_out,
+		      HTParentAnchor *anchor,
+		      FILE *fp,
+		      HTStream *sink,
+		      int (*copy_file) (FILE *, HTStream *))
 {
     HTStream *stream;
     HTStreamClass targetClass;
@@ -1477,7 +1617,7 @@ int HTParseFile(HTFormat rep_in,
 	     * current method smells anyway.
 	     */
 	    targetClass = *(stream->isa);	/* Copy pointers to procedures */
-	    rv = HTFileCopy(fp, stream);
+	    rv = (*copy_file) (fp, stream);
 	    if (rv == -1 || rv == HT_INTERRUPTED) {
 		(*targetClass._abort) (stream, NULL);
 	    } else {
@@ -1496,6 +1636,54 @@ int HTParseFile(HTFormat rep_in,
     return result;
 }
 
+/*	Parse a file given format and file pointer
+ *
+ *   This routine is responsible for creating and PRESENTING any
+ *   graphic (or other) objects described by the file.
+ *
+ *   The file number given is assumed to be a TELNET stream ie containing
+ *   CRLF at the end of lines which need to be stripped to \n for unix
+ *   when the format is textual.
+ *
+ *  State of file and target stream on entry:
+ *			FILE* (fp) assumed open,
+ *			target (sink) usually NULL (will call stream stack).
+ *
+ *  Return values:
+ *	-501		Stream stack failed (cannot present or convert).
+ *	-1		Download cancelled.
+ *	HT_NO_DATA	Error before any data read.
+ *	HT_PARTIAL_CONTENT	Interruption or error after some data read.
+ *	HT_LOADED	Normal end of file indication on reading.
+ *
+ *  State of file and target stream on return:
+ *	always		fp still open; target freed, aborted, or NULL.
+ */
+int HTParseFile(HTFormat rep_in,
+		HTFormat format_out,
+		HTParentAnchor *anchor,
+		FILE *fp,
+		HTStream *sink)
+{
+    return parse_file(rep_in, format_out, anchor, fp, sink, HTFileCopy);
+}
+
+#ifdef USE_SOURCE_CACHE
+/*	Parse a source-cache file given format and file pointer
+ *
+ *   This is like HTParseFile, but maps the file into memory if possible
+ *   (see HTMappedFileCopy).
+ */
+int HTParseMappedFile(HTFormat rep_in,
+		      HTFormat format_out,
+		      HTParentAnchor *anchor,
+		      FILE *fp,
+		      HTStream *sink)
+{
+    return parse_file(rep_in, format_out, anchor, fp, sink, HTMappedFileCopy);
+}
+#endif
+
 #ifdef USE_SOURCE_CACHE
 /*	Parse a document in memory given format and memory block pointer
  *
@@ -1793,6 +1981,83 @@ int HTParseBzFile(HTFormat rep_in,
 }
 #endif /* USE_BZLIB */
 
+#ifdef USE_ZSTD
+/*	HTParseZstdFile
+ *
+ *  State of file and target stream on entry:
+ *			FILE (zsfp) assumed open,
+ *			target (sink) usually NULL (will call stream stack).
+ *
+ *  Return values:
+ *	-501		Stream stack failed (cannot present or convert).
+ *	-1		Download cancelled.
+ *	HT_NO_DATA	Error before any data read.
+ *	HT_PARTIAL_CONTENT	Interruption or error after some data read.
+ *	HT_LOADED	Normal end of file indication on reading.
+ *
+ *  State of file and target stream on return:
+ *	always		zsfp closed; target freed, aborted, or NULL.
+ */
+int HTParseZstdFile(HTFormat rep_in,
+		    HTFormat format_out,
+		    HTParentAnchor *anchor,
+		    FILE *zsfp,
+		    HTStream *sink)
+{
+    HTStream *stream;
+    HTStreamClass targetClass;
+    int rv;
+    int result;
+
+    stream = HTStreamStack(rep_in, format_out, sink, anchor);
+    if (stream != 0 && stream->isa != 0) {
+	HTStream *decoder = HTDecoderStream("zstd", stream);
+
+	if (decoder == 0)
+	    (*stream->isa->_abort) (stream, NULL);
+	stream = decoder;
+    }
+
+    if (!stream || !stream->isa) {
+	char *buffer = 0;
+
+	fclose(zsfp);
+	if (LYCancelDownload) {
+	    LYCancelDownload = FALSE;
+	    result = -1;
+	} else {
+	    HTSprintf0(&buffer, CANNOT_CONVERT_I_TO_O,
+		       HTAtom_name(rep_in), HTAtom_name(format_out));
+	    CTRACE((tfp, "HTFormat(in HTParseZstdFile): %s\n", buffer));
+	    rv = HTLoadError(sink, 501, buffer);
+	    FREE(buffer);
+	    result = rv;
+	}
+    } else {
+	/*
+	 * Push the data down the stream, through the decoder.
+	 */
+	targetClass = *(stream->isa);	/* Copy pointers to procedures */
+	rv = HTFileCopy(zsfp, stream);
+	if (rv == -1 || rv == HT_INTERRUPTED) {
+	    (*targetClass._abort) (stream, NULL);
+	} else {
+	    (*targetClass._free) (stream);
+	}
+
+	fclose(zsfp);
+	if (rv == -1) {
+	    result = HT_NO_DATA;
+	} else if (rv == HT_INTERRUPTED || (rv > 0 && rv != HT_LOADED)) {
+	    result = HT_PARTIAL_CONTENT;
+	} else {
+	    result = HT_LOADED;
+	}
+    }
+    return result;
+}
+#endif /* USE_ZSTD */
+
 /*	Converter stream: Network Telnet to internal character text
  *	-----------------------------------------------------------
  *
@@ -1879,6 +2144,310 @@ HTStream *HTNetToText(HTStream *sink)
     return me;
 }
 
+#ifdef USE_DECODER
+/*	Converter stream: uncompress data as it arrives
+ *	-----------------------------------------------
+ *
+ *	This does for a Content-Encoding what HTGzFileCopy, HTZzFileCopy and
+ *	HTBzFileCopy do for a temporary file, but a chunk at a time, so that
+ *	the document can be displayed while it is still being received.
+ */
+static BOOL Decoder_start(HTStream *me)
+{
+    int status = -1;
+
+    switch (me->method) {
+#ifdef USE_ZLIB
+    case cftGzip:
+    case cftDeflate:
+	memset(&me->zs, 0, sizeof(me->zs));
+	if (me->method == cftGzip) {
+	    status = inflateInit2(&me->zs, MAX_WBITS + 32);	/* gzip or zlib */
+	} else if (me->head_len < 2) {
+	    return YES;		/* wait for the header */
+	} else if ((me->head[0] & 0x0f) == Z_DEFLATED
+		   && (UCH(me->head[0]) * 256 + UCH(me->head[1])) % 31 == 0) {
+	    status = inflateInit(&me->zs);
+	} else {
+	    /*
+	     * Some servers send "deflate" without the zlib header.
+	     */
+	    status = inflateInit2(&me->zs, -MAX_WBITS);
+	}
+	if (status != Z_OK) {
+	    CTRACE((tfp, "Decoder inflateInit() %s\n", zError(status)));
+	}
+	status = (status == Z_OK);
+	break;
+#endif
+#ifdef USE_BZLIB
+    case cftBzip2:
+	memset(&me->bz, 0, sizeof(me->bz));
+	status = BZ2_bzDecompressInit(&me->bz, 0, 0);
+	if (status != BZ_OK) {
+	    CTRACE((tfp, "Decoder BZ2_bzDecompressInit() %d\n", status));
+	}
+	status = (status == BZ_OK);
+	break;
+#endif
+#ifdef USE_ZSTD
+    case cftZstd:
+	if ((me->zds = ZSTD_createDStream()) != NULL) {
+	    size_t rc = ZSTD_initDStream(me->zds);
+
+	    if (ZSTD_isError(rc)) {
+		CTRACE((tfp, "Decoder ZSTD_initDStream() %s\n",
+			ZSTD_getErrorName(rc)));
+		ZSTD_freeDStream(me->zds);
+		me->zds = NULL;
+	    }
+	}
+	status = (me->zds != NULL);
+	break;
+#endif
+    default:
+	status = 0;
+	break;
+    }
+    me->ready = (BOOL) (status > 0);
+    return me->ready;
+}
+
+static void Decoder_finish(HTStream *me)
+{
+    if (me->ready) {
+	switch (me->method) {
+#ifdef USE_ZLIB
+	case cftGzip:
+	case cftDeflate:
+	    inflateEnd(&me->zs);
+	    break;
+#endif
+#ifdef USE_BZLIB
+	case cftBzip2:
+	    BZ2_bzDecompressEnd(&me->bz);
+	    break;
+#endif
+#ifdef USE_ZSTD
+	case cftZstd:
+	    ZSTD_freeDStream(me->zds);
+	    me->zds = NULL;
+	    break;
+#endif
+	default:
+	    break;
+	}
+	me->ready = NO;
+    }
+}
+
+#ifdef USE_ZLIB
+static void Decoder_feed(HTStream *me, const char *s, int l)
+{
+    char output_buffer[INPUT_BUFFER_SIZE];
+    int status;
+    int len;
+
+    me->zs.next_in = (Bytef *) DeConst(s);
+    me->zs.avail_in = (uInt) l;
+    me->zs.avail_out = 0;
+    while ((me->zs.avail_in != 0 || me->zs.avail_out == 0) && !me->done) {
+	me->zs.next_out = (Bytef *) output_buffer;
+	me->zs.avail_out = sizeof(output_buffer);
+	status = inflate(&me->zs, Z_NO_FLUSH);
+	len = (int) (sizeof(output_buffer) - me->zs.avail_out);
+	if (len > 0)
+	    (*me->sink->isa->put_block) (me->sink, output_buffer, len);
+	if (status == Z_STREAM_END) {
+	    /*
+	     * A gzip file may hold several members; anything else after the
+	     * end of the data is ignored.
+	     */
+	    if (me->method != cftGzip
+		|| (me->zs.avail_in != 0 && *me->zs.next_in != '\037')
+		|| inflateReset(&me->zs) != Z_OK) {
+		me->done = YES;
+	    }
+	} else if (status == Z_BUF_ERROR) {
+	    break;		/* needs more input */
+	} else if (status != Z_OK) {
+	    CTRACE((tfp, "Decoder inflate() %s\n", zError(status)));
+	    me->done = YES;
+	}
+    }
+}
+
+static void Decoder_inflate(HTStream *me, const char *s, int l)
+{
+    if (!me->ready) {
+	/*
+	 * Collect the first two bytes of "deflate" data to see if there is
+	 * a zlib header before starting.
+	 */
+	while (me->head_len < 2 && l > 0) {
+	    me->head[me->head_len++] = *s++;
+	    --l;
+	}
+	if (me->head_len < 2)
+	    return;
+	if (!Decoder_start(me)) {
+	    me->done = YES;
+	    return;
+	}
+	Decoder_feed(me, me->head, me->head_len);
+    }
+    if (l > 0)
+	Decoder_feed(me, s, l);
+}
+#endif /* USE_ZLIB */
+
+#ifdef USE_BZLIB
+static void Decoder_bunzip(HTStream *me, const char *s, int l)
+{
+    char output_buffer[INPUT_BUFFER_SIZE];
+    int status;
+    int len;
+
+    me->bz.next_in = (char *) DeConst(s);
+    me->bz.avail_in = (unsigned) l;
+    me->bz.avail_out = 0;
+    while ((me->bz.avail_in != 0 || me->bz.avail_out == 0) && !me->done) {
+	me->bz.next_out = output_buffer;
+	me->bz.avail_out = sizeof(output_buffer);
+	status = BZ2_bzDecompress(&me->bz);
+	len = (int) (sizeof(output_buffer) - me->bz.avail_out);
+	if (len > 0)
+	    (*me->sink->isa->put_block) (me->sink, output_buffer, len);
+	if (status == BZ_STREAM_END) {
+	    me->done = YES;
+	} else if (status == BZ_OK && len == 0 && me->bz.avail_in == 0) {
+	    break;		/* needs more input */
+	} else if (status != BZ_OK) {
+	    CTRACE((tfp, "Decoder BZ2_bzDecompress() %d\n", status));
+	    me->done = YES;
+	}
+    }
+}
+#endif /* USE_BZLIB */
+
+#ifdef USE_ZSTD
+static void Decoder_unzstd(HTStream *me, const char *s, int l)
+{
+    char output_buffer[INPUT_BUFFER_SIZE];
+    ZSTD_inBuffer input;
+    ZSTD_outBuffer output;
+    size_t rc;
+
+    input.src = s;
+    input.size = (size_t) l;
+    input.pos = 0;
+    output.size = 0;
+    output.pos = 0;
+    while ((input.pos < input.size || output.pos == output.size) && !me->done) {
+	output.dst = output_buffer;
+	output.size = sizeof(output_buffer);
+	output.pos = 0;
+	rc = ZSTD_decompressStream(me->zds, &output, &input);
+	if (output.pos != 0)
+	    (*me->sink->isa->put_block) (me->sink, output_buffer, (int) output.pos);
+	if (ZSTD_isError(rc)) {
+	    CTRACE((tfp, "Decoder ZSTD_decompressStream() %s\n",
+		    ZSTD_getErrorName(rc)));
+	    me->done = YES;
+	} else if (output.pos == 0 && input.pos == input.size) {
+	    break;		/* needs more input */
+	}
+    }
+}
+#endif /* USE_ZSTD */
+
+static void Decoder_put_block(HTStream *me, const char *s, int l)
+{
+    if (me->done || l <= 0)
+	return;
+
+    switch (me->method) {
+#ifdef USE_ZLIB
+    case cftGzip:
+    case cftDeflate:
+	Decoder_inflate(me, s, l);
+	break;
+#endif
+#ifdef USE_BZLIB
+    case cftBzip2:
+	Decoder_bunzip(me, s, l);
+	break;
+#endif
+#ifdef USE_ZSTD
+    case cftZstd:
+	Decoder_unzstd(me, s, l);
+	break;
+#endif
+    default:
+	break;
+    }
+}
+
+static void Decoder_put_character(HTStream *me, int c)
+{
+    char ch = (char) c;
+
+    Decoder_put_block(me, &ch, 1);
+}
+
+static void Decoder_put_string(HTStream *me, const char *s)
+{
+    Decoder_put_block(me, s, (int) strlen(s));
+}
+
+static void Decoder_free(HTStream *me)
+{
+    Decoder_finish(me);
+    (me->sink->isa->_free) (me->sink);	/* Close rest of pipe */
+    FREE(me);
+}
+
+static void Decoder_abort(HTStream *me, HTError e)
+{
+    Decoder_finish(me);
+    me->sink->isa->_abort(me->sink, e);		/* Abort rest of pipe */
+    FREE(me);
+}
+
+/*	The class structure
+*/
+static HTStreamClass DecoderClass =
+{
+    "Decoder",
+    Decoder_free,
+    Decoder_abort,
+    Decoder_put_character,
+    Decoder_put_string,
+    Decoder_put_block
+};
+
+/*	The creation method
+*/
+HTStream *HTDecoderStream(const char *encoding, HTStream *sink)
+{
+    HTStream *me = typecalloc(HTStream);
+
+    if (me == NULL)
+	outofmem(__FILE__, "HTDecoderStream");
+
+    assert(me != NULL);
+
+    me->isa = &DecoderClass;
+
+    me->sink = sink;
+    me->method = HTEncodingToCompressType(encoding);
+    if (!Decoder_start(me)) {
+	FREE(me);
+    }
+    return me;
+}
+#endif /* USE_DECODER */
+
 static HTStream HTBaseStreamInstance;	/* Made static */
 
 /*
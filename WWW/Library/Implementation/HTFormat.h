@@ -31,6 +31,10 @@
 #include <zlib.h>
 #endif
 
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -215,10 +219,12 @@ The HTPresentation and HTConverter types
 	,encodingDEFLATE = 2
 	,encodingCOMPRESS = 4
 	,encodingBZIP2 = 8
+	,encodingZSTD = 16
 	,encodingALL = (encodingGZIP
 			+ encodingDEFLATE
 			+ encodingCOMPRESS
-			+ encodingBZIP2)
+			+ encodingBZIP2
+			+ encodingZSTD)
     } AcceptEncoding;
 
 /*
@@ -361,6 +367,17 @@ HTCopy:  Copy a socket to a stream
 
 /*
 
+HTStreamFileno:  File to which a stream writes its data as is
+
+   If the data given to the stream from now on would be written unchanged to a
+   file, return its descriptor, after flushing what was written so far.
+   Otherwise return -1.
+
+ */
+    extern int HTStreamFileno(HTStream *sink);
+
+/*
+
 HTFileCopy:  Copy a file to a stream
 
    This is used by the protocol engines to send data down a stream, typically
@@ -450,6 +467,20 @@ HTParseFile: Parse a File through a file pointer
 #ifdef USE_SOURCE_CACHE
 /*
 
+HTParseMappedFile: Parse a source-cache file
+
+   This is like HTParseFile, but maps the file into memory if the system
+   supports that, rather than reading it through a buffer.
+
+ */
+    extern int HTParseMappedFile(HTFormat format_in,
+				 HTFormat format_out,
+				 HTParentAnchor *anchor,
+				 FILE *fp,
+				 HTStream *sink);
+
+/*
+
 HTParseMem: Parse a document in memory
 
    This routine is called by protocols modules to load an object.  uses
@@ -509,6 +540,22 @@ HTParseBzFile: Parse a bzip2'ed File through a file pointer
 
 #endif				/* USE_BZLIB */
 
+#ifdef USE_ZSTD
+/*
+HTParseZstdFile: Parse a zstd'ed File through a file pointer
+
+   This routine is called by protocols modules to load an object.  uses
+   HTStreamStack and HTDecoderStream.  Returns HT_LOADED if successful, can
+   also return HT_PARTIAL_CONTENT, HT_NO_DATA, or other <0 for failure.
+ */
+    extern int HTParseZstdFile(HTFormat format_in,
+			       HTFormat format_out,
+			       HTParentAnchor *anchor,
+			       FILE *zsfp,
+			       HTStream *sink);
+
+#endif				/* USE_ZSTD */
+
 /*
 
 HTNetToText: Convert Net ASCII to local representation
@@ -521,6 +568,20 @@ HTNetToText: Convert Net ASCII to local representation
  */
     extern HTStream *HTNetToText(HTStream *sink);
 
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
+/*
+
+HTDecoderStream: Uncompress a Content-Encoding
+
+   This is a filter stream which uncompresses data as it arrives, for the
+   encodings which can be handled with zlib ("gzip", "deflate"), bzlib
+   ("bzip2") or libzstd ("zstd"), and passes the result to the sink.  It
+   returns NULL if the encoding cannot be handled that way.
+
+ */
+    extern HTStream *HTDecoderStream(const char *encoding, HTStream *sink);
+#endif
+
 /*
 
 HTFormatInit: Set up default presentations and conversions
@@ -2156,6 +2156,17 @@ static const HTStreamClass HTMIME =
     HTMIME_write
 };
 
+/*
+ * If the headers have been parsed, and the rest of the data is passed through
+ * as is, return the stream which receives it.
+ */
+HTStream *HTMIMETarget(HTStream *me)
+{
+    if (me != 0 && me->isa == &HTMIME && me->state == MIME_TRANSPARENT)
+	return me->target;
+    return 0;
+}
+
 /*	Subclass-specific Methods
  *	-------------------------
  */
@@ -64,6 +64,13 @@ extern "C" {
 				    HTParentAnchor *anchor,
 				    HTStream *sink);
 
+/*
+
+  The stream which receives the body unchanged, once the headers are parsed.
+
+ */
+    extern HTStream *HTMIMETarget(HTStream *me);
+
 /*
 
   For handling Japanese headers.
@@ -38,6 +38,18 @@ struct struct_parts {
     char *anchor;
 };
 
+/*
+ * A base URL which has been cut up by scan(), to be reused by HTParseRelative
+ * for each reference resolved against it.
+ */
+struct _HTParsedBase {
+    char *name;			/* the URL as given */
+    size_t length;		/* ...its length */
+    char *buffer;		/* the copy which scan() cut up */
+    char *query;		/* "?" and parts.search, if the host ended there */
+    struct struct_parts parts;
+};
+
 #if 0				/* for debugging */
 static void show_parts(const char *name, struct struct_parts *parts, int line)
 {
@@ -326,9 +338,10 @@ static void convert_to_idna(char *host)
  * On exit,
  *     returns         A pointer to a malloc'd string which MUST BE FREED
  */
-char *HTParse(const char *aName,
-	      const char *relatedName,
-	      int wanted)
+static char *parse_url(const char *aName,
+		       const char *relatedName,
+		       HTParsedBase *parsed,
+		       int wanted)
 {
     char *result = NULL;
     char *tail = NULL;		/* a pointer to the end of the 'result' string */
@@ -366,7 +379,7 @@ char *HTParse(const char *aName,
      * Allocate the temporary string. Optimized.
      */
     len1 = strlen(aName) + 1;
-    len2 = strlen(relatedName) + 1;
+    len2 = ((parsed != 0) ? parsed->length : strlen(relatedName)) + 1;
     len = len1 + len2 + MIN_PARSE;	/* Lots of space: more than enough */
 
     need = (len * 2 + len1 + len2);
@@ -409,6 +422,8 @@ char *HTParse(const char *aName,
 	related.relative = NULL;
 	related.search = NULL;
 	related.anchor = NULL;
+    } else if (parsed != 0) {
+	related = parsed->parts;
     } else {
 	MemCpy(rel, relatedName, len2);
 	scan(rel, &related);
@@ -561,8 +576,12 @@ char *HTParse(const char *aName,
 	given.absolute[0] = '?';
     } else if (related.search && !related.absolute &&
 	       *(related.search - 1) == '\0') {
-	related.absolute = related.search - 1;
-	related.absolute[0] = '?';
+	if (parsed != 0) {
+	    related.absolute = parsed->query;	/* do not alter the base */
+	} else {
+	    related.absolute = related.search - 1;
+	    related.absolute[0] = '?';
+	}
     }
 
     /*
@@ -749,6 +768,58 @@ char *HTParse(const char *aName,
     return return_value;	/* exactly the right length */
 }
 
+char *HTParse(const char *aName,
+	      const char *relatedName,
+	      int wanted)
+{
+    return parse_url(aName, relatedName, (HTParsedBase *) 0, wanted);
+}
+
+/*	Parse a Name relative to a reusable base.		HTParseRelative()
+ *	-----------------------------------------
+ *
+ *	This gives the same result as HTParse(), but keeps relatedName cut up
+ *	into its parts in *base, so that resolving the many references in a
+ *	document against the same base does not copy and scan it each time.
+ *	The parts are made again whenever relatedName changes.
+ */
+char *HTParseRelative(const char *aName,
+		      HTParsedBase **base,
+		      const char *relatedName,
+		      int wanted)
+{
+    HTParsedBase *parsed = *base;
+
+    if (parsed == 0 || strcmp(parsed->name, relatedName)) {
+	HTParseFreeBase(base);
+	if ((parsed = typecalloc(HTParsedBase)) == 0)
+	    outofmem(__FILE__, "HTParseRelative");
+
+	assert(parsed != NULL);
+
+	StrAllocCopy(parsed->name, relatedName);
+	StrAllocCopy(parsed->buffer, relatedName);
+	parsed->length = strlen(relatedName);
+	scan(parsed->buffer, &parsed->parts);
+	if (parsed->parts.search != 0)
+	    HTSprintf0(&(parsed->query), "?%s", parsed->parts.search);
+	*base = parsed;
+    }
+    return parse_url(aName, parsed->name, parsed, wanted);
+}
+
+void HTParseFreeBase(HTParsedBase **base)
+{
+    HTParsedBase *parsed = *base;
+
+    if (parsed != 0) {
+	FREE(parsed->name);
+	FREE(parsed->buffer);
+	FREE(parsed->query);
+	FREE(*base);
+    }
+}
+
 /*	HTParseAnchor(), fast HTParse() specialization
  *	----------------------------------------------
  *
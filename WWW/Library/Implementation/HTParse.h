@@ -83,6 +83,22 @@ extern "C" {
 			 const char *relatedName,
 			 int wanted);
 
+/*	Parse a Name relative to a reusable base.		HTParseRelative()
+ *	-----------------------------------------
+ *
+ *	Like HTParse(), but *base holds relatedName already cut up into its
+ *	parts, made on the first call and again when relatedName changes.  It
+ *	must be freed with HTParseFreeBase().
+ */
+    typedef struct _HTParsedBase HTParsedBase;
+
+    extern char *HTParseRelative(const char *aName,
+				 HTParsedBase **base,
+				 const char *relatedName,
+				 int wanted);
+
+    extern void HTParseFreeBase(HTParsedBase **base);
+
 /*	HTParseAnchor(), fast HTParse() specialization
  *	----------------------------------------------
  *
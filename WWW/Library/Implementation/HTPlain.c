@@ -200,6 +200,30 @@ static void HTPlain_write(HTStream *me, const char *s, int l)
 	    HText_appendCharacter(me->text, *p);
 	}
 #else
+	/*
+	 * Runs of printable ASCII need no translation, and are simply
+	 * appended.  Underscores may begin an overstrike, so they are
+	 * handled below.
+	 */
+	if (!HTPlain_bs_pending &&
+	    LYlowest_eightbit[me->inUCLYhndl] >= 127) {
+	    size_t n = UCAsciiSpan(p, (size_t) (e - p), '_', 0);
+
+	    if (n != 0) {
+		const char *q = p + n;
+
+		if (me->T.decode_utf8) {
+		    me->U.utf_count = 0;
+		    me->U.utf_buf_p = me->U.utf_buf;
+		}
+		me->U.utf_buf[0] = '\0';
+		HTPlain_lastraw = UCH(q[-1]);
+		while (p < q)
+		    HText_appendCharacter(me->text, *p++);
+		if (p >= e)
+		    break;
+	    }
+	}
 	if (*p == '\b') {
 	    if (HTPlain_lastraw >= UCH(' ') &&
 		HTPlain_lastraw != '\r' && HTPlain_lastraw != '\n') {
@@ -40,8 +40,23 @@ typedef struct _rule {
     char *equiv;
     char *condition_op;		/* as strings - may be inefficient, */
     char *condition;		/* but this is not for a server - kw */
+    int order;			/* position in list, for the index */
 } rule;
 
+/*
+ * The rules are indexed by the literal part of their patterns, i.e., up to the
+ * first '*', in a trie.  Each node lists the rules whose literal part ends
+ * there, in the order of the list.  The rules which may match a string are
+ * those on the path which the string follows from the root.
+ */
+typedef struct _rule_node {
+    struct _rule_node *child;	/* first node for the following character */
+    struct _rule_node *sibling;	/* next node for the same position */
+    rule **rules;
+    int nrules;
+    char ch;
+} rule_node;
+
 #ifndef NO_RULES
 
 #include <HTTP.h>		/* for redirecting_url, indirectly HTPermitRedir - kw */
@@ -68,6 +83,99 @@ static rule *rules = 0;		/* Pointer to first on list */
 static rule *rule_tail = 0;	/* Pointer to last on list */
 #endif
 
+static rule_node *rule_trie = 0;	/* index of the rules */
+static int rule_count = 0;
+
+static void free_rule_node(rule_node * node)
+{
+    while (node != 0) {
+	rule_node *next = node->sibling;
+
+	free_rule_node(node->child);
+	FREE(node->rules);
+	FREE(node);
+	node = next;
+    }
+}
+
+/*
+ * Add a rule to the index, keeping each node's rules in order.
+ */
+static void index_rule(rule * r)
+{
+    rule_node *node;
+    const char *s;
+    int n;
+
+    if (rule_trie == 0) {
+	if ((rule_trie = typecalloc(rule_node)) == 0)
+	    outofmem(__FILE__, "index_rule");
+    }
+    node = rule_trie;
+    for (s = r->pattern; *s != '\0' && *s != '*'; ++s) {
+	rule_node *child;
+
+	for (child = node->child; child != 0; child = child->sibling) {
+	    if (child->ch == *s)
+		break;
+	}
+	if (child == 0) {
+	    if ((child = typecalloc(rule_node)) == 0)
+		outofmem(__FILE__, "index_rule");
+	    child->ch = *s;
+	    child->sibling = node->child;
+	    node->child = child;
+	}
+	node = child;
+    }
+
+    node->rules = typeRealloc(rule *, node->rules, (size_t) node->nrules + 1);
+    if (node->rules == 0)
+	outofmem(__FILE__, "index_rule");
+    for (n = node->nrules; n > 0 && node->rules[n - 1]->order > r->order; --n)
+	node->rules[n] = node->rules[n - 1];
+    node->rules[n] = r;
+    node->nrules++;
+}
+
+/*
+ * Return the first rule after 'after' (or the first rule, if it is null)
+ * whose literal part is a prefix of 'current'.
+ */
+static rule *next_rule(const char *current, rule * after)
+{
+    rule *result = 0;
+    rule_node *node = rule_trie;
+    const char *s = current;
+
+    while (node != 0) {
+	int lo = 0;
+	int hi = node->nrules;
+
+	/* find the node's first rule after 'after' */
+	while (after != 0 && lo < hi) {
+	    int mid = (lo + hi) / 2;
+
+	    if (node->rules[mid]->order <= after->order)
+		lo = mid + 1;
+	    else
+		hi = mid;
+	}
+	if (lo < node->nrules
+	    && (result == 0 || node->rules[lo]->order < result->order))
+	    result = node->rules[lo];
+
+	if (*s == '\0')
+	    break;
+	for (node = node->child; node != 0; node = node->sibling) {
+	    if (node->ch == *s)
+		break;
+	}
+	++s;
+    }
+    return result;
+}
+
 /*	Add rule to the list					HTAddRule()
  *	--------------------
  *
@@ -108,6 +216,11 @@ int HTAddRule(HTRuleOp op, const char *pattern,
     StrAllocCopy(pPattern, pattern);
     temp->pattern = pPattern;
     temp->op = op;
+#ifdef PUT_ON_HEAD
+    temp->order = -(++rule_count);
+#else
+    temp->order = ++rule_count;
+#endif
 
     if (equiv) {
 	CTRACE((tfp, "Rule: For `%s' op %d `%s'", pattern, (int) op, equiv));
@@ -136,6 +249,7 @@ int HTAddRule(HTRuleOp op, const char *pattern,
 	rules = temp;
     rule_tail = temp;
 #endif
+    index_rule(temp);
 
     return 0;
 }
@@ -164,6 +278,9 @@ void HTClearRules(void)
 #ifndef PUT_ON_HEAD
     rule_tail = 0;
 #endif
+    free_rule_node(rule_trie);
+    rule_trie = 0;
+    rule_count = 0;
 }
 
 static BOOL rule_cond_ok(rule * r)
@@ -225,7 +342,7 @@ char *HTTranslate(const char *required)
 
     HTAA_clearProtections();	/* Reset from previous call -- AL */
 
-    for (r = rules; r; r = r->next) {
+    for (r = next_rule(current, 0); r; r = next_rule(current, r)) {
 	char *p = r->pattern;
 	int m = 0;		/* Number of characters matched against wildcard */
 	const char *q = current;
@@ -673,66 +673,113 @@ extern int h_errno;
 #endif
 #endif
 
-static BOOL setup_nsl_fork(void (*really) (const char *,
-					   const char *,
-					   STATUSES *,
-					   void **),
-			   unsigned (*readit) (int, char *, size_t),
-			   void (*dumpit) (const char *, const void *),
-			   const char *host,
-			   const char *port,
-			   void **rehostent)
+typedef void (*ReallyFunc) (const char *, const char *, STATUSES *, void **);
+
+/*
+ * Lookups started by HTPrefetchHost() before they are needed.  Each child
+ * writes its result to its pipe and exits; setup_nsl_fork() adopts the child
+ * and reads the pipe when the same host is looked up, rather than forking
+ * another.
+ */
+#define PREFETCH_LIMIT	4	/* at most this many lookups are kept */
+#define PREFETCH_EXPIRE	60	/* seconds after which a result is stale */
+
+typedef struct {
+    ReallyFunc really;
+    char *host;
+    char *port;
+    int pid;
+    int fd;
+    BOOL exited;
+    time_t started;
+} PREFETCHED;
+
+static PREFETCHED prefetched[PREFETCH_LIMIT];
+
+static void drop_prefetched(PREFETCHED * p, BOOL kill_it)
 {
-    static const char *this_func = "setup_nsl_fork";
+    if (kill_it) {
+	if (!p->exited) {
+	    kill(p->pid, SIGTERM);
+	    waitpid(p->pid, NULL, WNOHANG);
+	}
+	close(p->fd);
+    }
+    FREE(p->host);
+    FREE(p->port);
+    memset(p, 0, sizeof(*p));
+}
 
-    STATUSES statuses;
+static void expire_prefetched(void)
+{
+    time_t now = time((time_t *) 0);
+    int n;
 
-    /*
-     * fork-based gethostbyname() with checks for interrupts.
-     * - Tom Zerucha (tz@execpc.com) & FM
-     */
-    int got_rehostent = 0;
+    for (n = 0; n < PREFETCH_LIMIT; ++n) {
+	if (prefetched[n].host != 0
+	    && (now - prefetched[n].started) >= PREFETCH_EXPIRE) {
+	    CTRACE((tfp, "HTPrefetchHost: %s expired\n", prefetched[n].host));
+	    drop_prefetched(&prefetched[n], TRUE);
+	}
+    }
+}
+
+static PREFETCHED *find_prefetched(ReallyFunc really,
+				   const char *host,
+				   const char *port)
+{
+    int n;
+
+    for (n = 0; n < PREFETCH_LIMIT; ++n) {
+	PREFETCHED *p = &prefetched[n];
+
+	if (p->host != 0
+	    && p->really == really
+	    && !strcmp(p->host, host)
+	    && (port ? (p->port && !strcmp(p->port, port)) : !p->port))
+	    return p;
+    }
+    return 0;
+}
+
+/*
+ * Note that a child reaped by the caller is one of ours, so we do not wait
+ * for it (or kill some other process which reuses its pid) later.
+ */
+static void reaped_prefetched(int pid)
+{
+    int n;
+
+    for (n = 0; n < PREFETCH_LIMIT; ++n) {
+	if (prefetched[n].host != 0 && prefetched[n].pid == pid)
+	    prefetched[n].exited = TRUE;
+    }
+}
+
+/*
+ * Fork a child to do the lookup, returning its pid, and the read-side of the
+ * pipe on which it will write the result.
+ */
+static int start_nsl_fork(ReallyFunc really,
+			  const char *host,
+			  const char *port,
+			  int *readfd)
+{
+    STATUSES statuses;
 
 #if HAVE_SIGACTION
     sigset_t old_sigset;
     sigset_t new_sigset;
 #endif
-    /*
-     * Pipe, child pid, status buffers, start time, select() control
-     * variables.
-     */
-    int fpid, waitret;
-    int pfd[2], selret;
-    unsigned readret;
-
-#ifdef HAVE_TYPE_UNIONWAIT
-    union wait waitstat;
+    int fpid;
+    int pfd[2];
 
-#else
-    int waitstat = 0;
-#endif
-    time_t start_time = time((time_t *) 0);
-    fd_set readfds;
-    struct timeval one_second;
-    long dns_patience = 30;	/* how many seconds will we wait for DNS? */
-    int child_exited = 0;
+    /* the child's result, returned through the pipe */
+    void *rehostent = 0;
 
     memset(&statuses, 0, sizeof(STATUSES));
     statuses.h_errno_valid = NO;
 
-    /*
-     * Reap any children that have terminated since last time through.
-     * This might include children that we killed, then waited with WNOHANG
-     * before they were actually ready to be reaped.  (Should be max of 1
-     * in this state, but the loop is safe if waitpid() is implemented
-     * correctly:  returns 0 when children exist but none have exited; -1
-     * with errno == ECHILD when no children.) -BL
-     */
-    do {
-	waitret = waitpid(-1, 0, WNOHANG);
-    } while (waitret > 0 || (waitret == -1 && errno == EINTR));
-    waitret = 0;
-
     IGNORE_RC(pipe(pfd));
 
 #if HAVE_SIGACTION
@@ -809,7 +856,7 @@ static BOOL setup_nsl_fork(void (*really) (const char *,
 	h_errno = -2;
 #endif
 	set_errno(0);
-	really(host, port, &statuses, rehostent);
+	really(host, port, &statuses, &rehostent);
 	/*
 	 * Send variables indicating status of lookup to parent.  That
 	 * includes rehostentlen, which the parent will use as the size for
@@ -823,7 +870,7 @@ static BOOL setup_nsl_fork(void (*really) (const char *,
 	    /*
 	     * Return our resulting rehostent through pipe...
 	     */
-	    IGNORE_RC(write(pfd[1], *rehostent, statuses.rehostentlen));
+	    IGNORE_RC(write(pfd[1], rehostent, statuses.rehostentlen));
 	    close(pfd[1]);
 	    _exit(0);
 	} else {
@@ -841,18 +888,95 @@ static BOOL setup_nsl_fork(void (*really) (const char *,
     sigprocmask(SIG_SETMASK, &old_sigset, NULL);
 #endif /* HAVE_SIGACTION */
 
-    /*
-     * (parent) Wait until lookup finishes, or interrupt, or cycled too
-     * many times (just in case) -BL
-     */
-
     close(pfd[1]);		/* parent won't use write side -BL */
 
     if (fpid < 0) {		/* fork failed */
 	close(pfd[0]);
+    } else {
+	*readfd = pfd[0];
+    }
+    return fpid;
+}
+
+static BOOL setup_nsl_fork(ReallyFunc really,
+			   unsigned (*readit) (int, char *, size_t),
+			   void (*dumpit) (const char *, const void *),
+			   const char *host,
+			   const char *port,
+			   void **rehostent)
+{
+    static const char *this_func = "setup_nsl_fork";
+
+    STATUSES statuses;
+
+    /*
+     * fork-based gethostbyname() with checks for interrupts.
+     * - Tom Zerucha (tz@execpc.com) & FM
+     */
+    int got_rehostent = 0;
+
+    /*
+     * Pipe, child pid, status buffers, start time, select() control
+     * variables.
+     */
+    int fpid, waitret;
+    int pfd[2], selret;
+    unsigned readret;
+    PREFETCHED *p;
+
+#ifdef HAVE_TYPE_UNIONWAIT
+    union wait waitstat;
+
+#else
+    int waitstat = 0;
+#endif
+    time_t start_time = time((time_t *) 0);
+    fd_set readfds;
+    struct timeval one_second;
+    long dns_patience = 30;	/* how many seconds will we wait for DNS? */
+    int child_exited = 0;
+
+    memset(&statuses, 0, sizeof(STATUSES));
+    statuses.h_errno_valid = NO;
+
+    /*
+     * Reap any children that have terminated since last time through.
+     * This might include children that we killed, then waited with WNOHANG
+     * before they were actually ready to be reaped.  (Should be max of 1
+     * in this state, but the loop is safe if waitpid() is implemented
+     * correctly:  returns 0 when children exist but none have exited; -1
+     * with errno == ECHILD when no children.) -BL
+     */
+    do {
+	waitret = waitpid(-1, 0, WNOHANG);
+	if (waitret > 0)
+	    reaped_prefetched(waitret);
+    } while (waitret > 0 || (waitret == -1 && errno == EINTR));
+    waitret = 0;
+
+    expire_prefetched();
+    if ((p = find_prefetched(really, host, port)) != 0) {
+	/*
+	 * The lookup was started ahead of time; wait for its result as if we
+	 * had just forked it.
+	 */
+	CTRACE((tfp, "%s: using lookup prefetched for %s\n", this_func, host));
+	fpid = p->pid;
+	pfd[0] = p->fd;
+	if (p->exited) {
+	    child_exited = 1;
+	    waitret = fpid;
+	}
+	drop_prefetched(p, FALSE);
+    } else if ((fpid = start_nsl_fork(really, host, port, &pfd[0])) < 0) {
 	goto failed;
     }
 
+    /*
+     * (parent) Wait until lookup finishes, or interrupt, or cycled too
+     * many times (just in case) -BL
+     */
+
     while (child_exited || (long) (time((time_t *) 0) - start_time) < dns_patience) {
 
 	FD_ZERO(&readfds);
@@ -1596,6 +1720,32 @@ static void really_getaddrinfo(const char *host,
 }
 #endif /* NSL_FORK */
 
+/*
+ * Split "host:port" or "[address]:port" in place, returning the host, and
+ * using the default port if none is given.
+ */
+static char *split_host_port(char *s, char **port, char *pbuf, int defport)
+{
+    char *host;
+    char *p;
+
+    if (s[0] == '[' && (p = StrChr(s, ']')) != NULL) {
+	*p++ = '\0';
+	host = s + 1;
+    } else {
+	p = s;
+	host = &s[0];
+    }
+    *port = strrchr(p, ':');
+    if (*port) {
+	*(*port)++ = '\0';
+    } else {
+	sprintf(pbuf, "%d", defport);
+	*port = pbuf;
+    }
+    return host;
+}
+
 LYNX_ADDRINFO *HTGetAddrInfo(const char *str,
 			     const int defport)
 {
@@ -1608,27 +1758,12 @@ LYNX_ADDRINFO *HTGetAddrInfo(const char *str,
     int error;
 #endif /* NSL_FORK */
     LYNX_ADDRINFO *res;
-    char *p;
     char *s = NULL;
     char *host, *port;
     char pbuf[80];
 
     StrAllocCopy(s, str);
-
-    if (s[0] == '[' && (p = StrChr(s, ']')) != NULL) {
-	*p++ = '\0';
-	host = s + 1;
-    } else {
-	p = s;
-	host = &s[0];
-    }
-    port = strrchr(p, ':');
-    if (port) {
-	*port++ = '\0';
-    } else {
-	sprintf(pbuf, "%d", defport);
-	port = pbuf;
-    }
+    host = split_host_port(s, &port, pbuf, defport);
 
 #ifdef NSL_FORK
     if (setup_nsl_fork(really_getaddrinfo,
@@ -1659,6 +1794,76 @@ LYNX_ADDRINFO *HTGetAddrInfo(const char *str,
 }
 #endif /* INET6 */
 
+#ifdef NSL_FORK
+/*
+ * Start looking up the host of the given URL, without waiting for the result,
+ * so that it is ready (or at least under way) if the URL is loaded next.
+ */
+void HTPrefetchHost(const char *url, int default_port)
+{
+    char *p1 = HTParse(url, "", PARSE_HOST);
+    char *at_sign = StrChr(p1, '@');
+    char *s = NULL;
+    char *host;
+    char *port;
+    ReallyFunc really;
+    int n;
+
+#ifdef INET6
+    char pbuf[80];
+
+    StrAllocCopy(s, at_sign ? (at_sign + 1) : p1);
+    host = split_host_port(s, &port, pbuf, default_port);
+    really = really_getaddrinfo;
+#else
+    (void) default_port;
+
+    StrAllocCopy(s, at_sign ? (at_sign + 1) : p1);
+    host = s;
+    if ((port = StrChr(host, ':')) != NULL)
+	*port = '\0';
+    port = NULL;		/* LYGetHostByName() looks up the name only */
+    really = really_gethostbyname;
+#endif /* INET6 */
+    FREE(p1);
+
+    expire_prefetched();
+    if (*host != '\0'
+	&& host[strspn(host, "0123456789.")] != '\0'
+	&& valid_hostname(host)
+	&& find_prefetched(really, host, port) == 0) {
+	PREFETCHED *p = &prefetched[0];
+
+	/*
+	 * Use a free slot, or else replace the oldest lookup, which is the
+	 * least likely to be wanted since none of them has been used yet.
+	 */
+	for (n = 0; n < PREFETCH_LIMIT && p->host != 0; ++n) {
+	    if (prefetched[n].host == 0
+		|| prefetched[n].started < p->started)
+		p = &prefetched[n];
+	}
+	if (p->host != 0) {
+	    CTRACE((tfp, "HTPrefetchHost: %s replaced\n", p->host));
+	    drop_prefetched(p, TRUE);
+	}
+	CTRACE((tfp, "HTPrefetchHost: %s\n", host));
+	CTRACE_FLUSH(tfp);
+	p->pid = start_nsl_fork(really, host, port, &(p->fd));
+	if (p->pid > 0) {
+	    p->really = really;
+	    StrAllocCopy(p->host, host);
+	    StrAllocCopy(p->port, port);
+	    p->exited = FALSE;
+	    p->started = time((time_t *) 0);
+	} else {
+	    p->pid = 0;
+	}
+    }
+    FREE(s);
+}
+#endif /* NSL_FORK */
+
 #ifdef LY_FIND_LEAKS
 /*	Free our name for the host on which we are - FM
  *	-------------------------------------------
@@ -1775,8 +1980,6 @@ static BOOL HTWasInterrupted(int *status)
     return result;
 }
 
-#define TRIES_PER_SECOND 10
-
 /*
  * Set the select-timeout to 0.1 seconds.
  */
@@ -1786,11 +1989,290 @@ static void set_timeout(struct timeval *timeoutp)
     timeoutp->tv_usec = 100000;
 }
 
+/*
+ * The longest that wait_for_sockets() waits while it can also wait for the
+ * keyboard, i.e., how often its callers check their timeouts.
+ */
+#define WAIT_LIMIT_MSECS 1000
+
+static BOOL keyboard_woke = FALSE;
+
+/*
+ * Wait until one of the given sockets is ready, or a key is pressed, or the
+ * timeout expires.  Returns the number of ready sockets, zero if the wait
+ * ended for another reason (including a signal), or -1 on error.
+ *
+ * Selecting the keyboard along with the sockets lets the caller act on a key
+ * as soon as it is pressed, whether that interrupts the transfer or scrolls
+ * the partial display, rather than polling for it ten times a second.  We can
+ * do that only if the keyboard can be selected; slang may also have keys in
+ * its own buffer which select() does not see.  HTCheckForInterrupt() reads at
+ * most one key in each tenth of a second, so after a key, poll rather than
+ * wake again at once for the same key.
+ */
+static int wait_for_sockets(int nfds,
+			    fd_set * readfds,
+			    fd_set * writefds,
+			    long msecs)
+{
+    struct timeval select_timeout;
+    fd_set kbdfds;
+    int kbd_fd = INVSOC;
+    int ret;
+
+#ifndef USE_SLANG
+    if (!keyboard_woke && LYCanCheckForInterrupt())
+	kbd_fd = LYConsoleInputFD(TRUE);
+#endif
+    keyboard_woke = FALSE;
+
+    if (kbd_fd == INVSOC) {
+	set_timeout(&select_timeout);
+	if (msecs < (long) (select_timeout.tv_usec / 1000))
+	    select_timeout.tv_usec = msecs * 1000;
+    } else {
+	if (msecs > WAIT_LIMIT_MSECS)
+	    msecs = WAIT_LIMIT_MSECS;
+	select_timeout.tv_sec = msecs / 1000;
+	select_timeout.tv_usec = (msecs % 1000) * 1000;
+	if (readfds == NULL) {
+	    FD_ZERO(&kbdfds);
+	    readfds = &kbdfds;
+	}
+	FD_SET((unsigned) kbd_fd, readfds);
+	if (kbd_fd >= nfds)
+	    nfds = kbd_fd + 1;
+    }
+#ifdef SOCKS
+    if (socks_flag)
+	ret = Rselect(nfds, readfds, writefds, NULL, &select_timeout);
+    else
+#endif /* SOCKS */
+	ret = select(nfds, readfds, writefds, NULL, &select_timeout);
+
+    if (ret < 0) {
+	if (SOCKET_ERRNO == EINTR)
+	    ret = 0;
+    } else if (ret > 0 && kbd_fd != INVSOC && FD_ISSET(kbd_fd, readfds)) {
+	FD_CLR((unsigned) kbd_fd, readfds);
+	keyboard_woke = TRUE;
+	--ret;
+    }
+    return ret;
+}
+
 #ifndef MULTINET		/* SOCKET_ERRNO != errno ? */
 #if !defined(UCX) || !defined(VAXC)	/* errno not modifiable ? */
 #define SOCKET_DEBUG_TRACE	/* show errno status after some system calls */
 #endif /* UCX && VAXC */
 #endif /* MULTINET */
+#if defined(INET6) && (!defined(DOSPATH) || defined(__DJGPP__)) && (!defined(NO_IOCTL) || defined(USE_FCNTL))
+#define USE_PARALLEL_CONNECT 1
+#endif
+
+#ifdef USE_PARALLEL_CONNECT
+#define CONNECT_ATTEMPTS	16	/* addresses tried in parallel_connect() */
+#define CONNECT_DELAY_MSECS	250	/* RFC 8305's "Connection Attempt Delay" */
+
+static void trace_address(const char *what, LYNX_ADDRINFO *res)
+{
+    if (TRACE) {
+	char hostbuf[1024], portbuf[1024];
+
+	hostbuf[0] = '\0';
+	portbuf[0] = '\0';
+	getnameinfo(res->ai_addr, res->ai_addrlen,
+		    hostbuf, (socklen_t) sizeof(hostbuf),
+		    portbuf, (socklen_t) sizeof(portbuf),
+		    NI_NUMERICHOST | NI_NUMERICSERV);
+	CTRACE((tfp, "HTDoConnect: %s family %d addr %s port %s\n",
+		what, res->ai_family, hostbuf, portbuf));
+    }
+}
+
+/*
+ * Order the addresses as RFC 8305 suggests, alternating between the address
+ * families and starting with the resolver's first choice.  Then if one family
+ * does not work, that costs one attempt delay rather than a connect timeout
+ * for each of its addresses.
+ */
+static int order_addresses(LYNX_ADDRINFO *res0, LYNX_ADDRINFO **order)
+{
+    LYNX_ADDRINFO *same = res0;
+    LYNX_ADDRINFO *other = res0;
+    int count = 0;
+
+    while (count < CONNECT_ATTEMPTS && (same != 0 || other != 0)) {
+	while (same != 0 && same->ai_family != res0->ai_family)
+	    same = same->ai_next;
+	if (same != 0 && count < CONNECT_ATTEMPTS) {
+	    order[count++] = same;
+	    same = same->ai_next;
+	}
+	while (other != 0 && other->ai_family == res0->ai_family)
+	    other = other->ai_next;
+	if (other != 0 && count < CONNECT_ATTEMPTS) {
+	    order[count++] = other;
+	    other = other->ai_next;
+	}
+    }
+    return count;
+}
+
+/*
+ * Create a non-blocking socket and start connecting it.  Returns the socket,
+ * or -1 if the attempt failed at once.  Sets *done if it connected at once.
+ */
+static int start_connect(LYNX_ADDRINFO *res, BOOL *done)
+{
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    int ret;
+
+    *done = FALSE;
+    if (fd == -1) {
+	trace_address("socket failed for", res);
+	return -1;
+    }
+#ifdef USE_FCNTL
+    ret = fcntl(fd, F_SETFL, O_NONBLOCK);
+#else
+    {
+	int val = 1;
+
+	ret = IOCTL(fd, FIONBIO, &val);
+    }
+#endif /* USE_FCNTL */
+    if (ret == -1)
+	_HTProgress(gettext("Could not make connection non-blocking."));
+
+    trace_address("connecting to", res);
+    if (connect(fd, res->ai_addr, res->ai_addrlen) == 0) {
+	*done = TRUE;
+    } else if (SOCKET_ERRNO != EINPROGRESS
+#ifdef EAGAIN
+	       && SOCKET_ERRNO != EAGAIN
+#endif
+	) {
+	trace_address("connect failed for", res);
+	NETCLOSE(fd);
+	fd = -1;
+    }
+    return fd;
+}
+
+/*
+ * Connect to the first of several addresses which answers, as in RFC 8305
+ * ("Happy Eyeballs").  Rather than waiting for each address in turn to fail,
+ * which may take the whole connect timeout, start another attempt whenever
+ * the previous one has not completed within the attempt delay, or has failed.
+ * Keep the socket of the first attempt which succeeds, closing the others.
+ */
+static int parallel_connect(LYNX_ADDRINFO *res0, int *s)
+{
+    LYNX_ADDRINFO *order[CONNECT_ATTEMPTS];
+    int fds[CONNECT_ATTEMPTS];
+    int count = order_addresses(res0, order);
+    int started = 0;
+    int pending = 0;
+    int status = -1;
+    int n;
+    double began = HTTimeNow();
+    double next_start = began;
+    double now;
+
+    *s = -1;
+    while (*s < 0) {
+	fd_set writefds;
+	int maxfd = -1;
+	long msecs;
+	int ret;
+
+	now = HTTimeNow();
+	if (now - began >= connect_timeout) {
+	    HTAlert(gettext("Connection failed (too many retries)."));
+	    status = HT_NO_DATA;
+	    break;
+	}
+
+	/*
+	 * Start the next attempt when its delay has passed, or at once if no
+	 * attempt is in progress.
+	 */
+	if (started < count && (pending == 0 || now >= next_start)) {
+	    BOOL done;
+
+	    fds[started] = start_connect(order[started], &done);
+	    if (done) {
+		*s = fds[started];
+		fds[started] = -1;
+	    } else if (fds[started] >= 0) {
+		++pending;
+		next_start = now + (CONNECT_DELAY_MSECS / 1000.0);
+	    } else {
+		next_start = now;	/* try the next address at once */
+	    }
+	    ++started;
+	    continue;
+	}
+	if (pending == 0)
+	    break;
+
+	FD_ZERO(&writefds);
+	for (n = 0; n < started; ++n) {
+	    if (fds[n] >= 0) {
+		FD_SET((unsigned) fds[n], &writefds);
+		if (fds[n] > maxfd)
+		    maxfd = fds[n];
+	    }
+	}
+	msecs = (long) ((began + connect_timeout - now) * 1000);
+	if (started < count && (long) ((next_start - now) * 1000) < msecs)
+	    msecs = (long) ((next_start - now) * 1000);
+	if (msecs < 0)
+	    msecs = 0;
+
+	ret = wait_for_sockets(maxfd + 1, NULL, &writefds, msecs);
+	if (ret < 0) {
+	    HTInetStatus("select");
+	    break;
+	}
+	for (n = 0; n < started && ret > 0; ++n) {
+	    if (fds[n] >= 0 && FD_ISSET(fds[n], &writefds)) {
+		int error = 0;
+		socklen_t len = (socklen_t) sizeof(error);
+
+		--ret;
+		if (getsockopt(fds[n], SOL_SOCKET, SO_ERROR,
+			       (void *) &error, &len) == 0 && error == 0) {
+		    trace_address("connected to", order[n]);
+		    *s = fds[n];
+		    fds[n] = -1;
+		    --pending;
+		    break;
+		}
+		trace_address("connect failed for", order[n]);
+		NETCLOSE(fds[n]);
+		fds[n] = -1;
+		--pending;
+		next_start = now;	/* try the next address at once */
+	    }
+	}
+	if (*s < 0 && HTWasInterrupted(&status)) {
+	    CTRACE((tfp, "*** INTERRUPTED in middle of connect.\n"));
+	    break;
+	}
+    }
+
+    for (n = 0; n < started; ++n) {
+	if (fds[n] >= 0)
+	    NETCLOSE(fds[n]);
+    }
+    if (*s >= 0)
+	status = 0;
+    return status;
+}
+#endif /* USE_PARALLEL_CONNECT */
+
 /*
  *  Interruptible connect as implemented for Mosaic by Marc Andreesen
  *  and hacked in for Lynx years ago by Lou Montulli, and further
@@ -1838,6 +2320,7 @@ int HTDoConnect(const char *url,
 
     HTSprintf0(&line, "%s%s", WWW_FIND_MESSAGE, host);
     _HTProgress(line);
+    HTSetTimePhase(tpDNS);
 #ifdef INET6
     /* HTParseInet() is useless! */
     res0 = HTGetAddrInfo(host, default_port);
@@ -1871,6 +2354,7 @@ int HTDoConnect(const char *url,
     }
 #endif /* INET6 */
 
+    HTSetTimePhase(tpConnect);
     HTSprintf0(&line, gettext("Making %s connection to %s"), protocol, host);
     _HTProgress(line);
     FREE(host);
@@ -1886,7 +2370,18 @@ int HTDoConnect(const char *url,
 	return HT_NO_DATA;
     }
 #else
-    for (res = res0; res; res = res->ai_next) {
+    res = res0;
+#ifdef USE_PARALLEL_CONNECT
+    if (res0->ai_next != 0
+#ifdef SOCKS
+	&& !socks_flag
+#endif
+	) {
+	status = parallel_connect(res0, s);
+	res = 0;		/* instead of trying each address in turn */
+    }
+#endif /* USE_PARALLEL_CONNECT */
+    for (; res; res = res->ai_next) {
 	*s = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
 	if (*s == -1) {
 	    char hostbuf[1024], portbuf[1024];
@@ -1973,9 +2468,10 @@ int HTDoConnect(const char *url,
 	     || SOCKET_ERRNO == EAGAIN
 #endif
 	    )) {
-	    struct timeval select_timeout;
 	    int ret;
 	    int tries = 0;
+	    double began = HTTimeNow();
+	    double now;
 
 #ifdef SOCKET_DEBUG_TRACE
 	    HTInetStatus("this socket's first connect");
@@ -1987,7 +2483,9 @@ int HTDoConnect(const char *url,
 		/*
 		 * Protect against an infinite loop.
 		 */
-		if ((tries++ / TRIES_PER_SECOND) >= connect_timeout) {
+		++tries;
+		now = HTTimeNow();
+		if (now - began >= connect_timeout) {
 		    HTAlert(gettext("Connection failed (too many retries)."));
 #ifdef INET6
 		    FREE(line);
@@ -1998,32 +2496,17 @@ int HTDoConnect(const char *url,
 #endif /* INET6 */
 		    return HT_NO_DATA;
 		}
-		set_timeout(&select_timeout);
 		FD_ZERO(&writefds);
 		FD_SET((unsigned) *s, &writefds);
-#ifdef SOCKS
-		if (socks_flag)
-		    ret = Rselect(*s + 1, NULL,
-				  &writefds, NULL, &select_timeout);
-		else
-#endif /* SOCKS */
-		    ret = select(*s + 1,
-				 NULL,
-				 &writefds,
-				 NULL,
-				 &select_timeout);
+		ret = wait_for_sockets(*s + 1, NULL, &writefds,
+				       (long) ((began + connect_timeout - now)
+					       * 1000));
 
 #ifdef SOCKET_DEBUG_TRACE
 		if (tries == 1) {
 		    HTInetStatus("this socket's first select");
 		}
 #endif /* SOCKET_DEBUG_TRACE */
-		/*
-		 * If we suspend, then it is possible that select will be
-		 * interrupted.  Allow for this possibility.  - JED
-		 */
-		if ((ret == -1) && (errno == EINTR))
-		    continue;
 
 #ifdef SOCKET_DEBUG_TRACE
 		if (ret < 0) {
@@ -2192,12 +2675,87 @@ int HTDoConnect(const char *url,
     return status;
 }
 
+#ifdef HAVE_SPLICE
+static int write_all(int fd, const char *buf, ssize_t len)
+{
+    ssize_t n;
+
+    for (; len > 0; buf += n, len -= n) {
+	if ((n = write(fd, buf, (size_t) len)) < 0) {
+	    if (errno == EINTR)
+		n = 0;
+	    else
+		return -1;
+	}
+    }
+    return 0;
+}
+
 /*
- *  This is so interruptible reads can be implemented cleanly.
+ * Move what can be read from a socket to a file through a pipe, so that it is
+ * not copied to user space.  If the file cannot be spliced into, e.g., it is
+ * a terminal, copy the data from the pipe instead.
  */
-int HTDoRead(int fildes,
-	     void *buf,
-	     unsigned nbyte)
+static int splice_socket(int fildes, int fd_out, unsigned nbyte)
+{
+    static int pipe_fds[2] =
+    {-1, -1};
+    char buffer[BUFSIZ];
+    ssize_t result = -1;
+    ssize_t left;
+    ssize_t n;
+
+    if (pipe_fds[0] >= 0 || pipe(pipe_fds) == 0) {
+	while ((result = splice(fildes, NULL, pipe_fds[1], NULL,
+				(size_t) nbyte, SPLICE_F_MOVE)) == -1
+	       && errno == EINTR) {
+	    ;
+	}
+    } else {
+	pipe_fds[0] = pipe_fds[1] = -1;
+    }
+
+    if (result < 0) {
+	/* no pipe, or the socket does not support splice(): just read it */
+	CTRACE((tfp, "HTDoSplice: cannot splice, reading instead\n"));
+	while ((result = SOCKET_READ(fildes, buffer,
+				     HTMIN(nbyte, sizeof(buffer)))) == -1
+	       && errno == EINTR) {
+	    ;
+	}
+	if (result > 0 && write_all(fd_out, buffer, result) < 0)
+	    result = -1;
+	return (int) result;
+    }
+
+    for (left = result; left > 0; left -= n) {
+	n = splice(pipe_fds[0], NULL, fd_out, NULL, (size_t) left, SPLICE_F_MOVE);
+	if (n < 0 && errno == EINTR) {
+	    n = 0;
+	} else if (n <= 0) {
+	    /* the file does not support splice(): copy it from the pipe */
+	    n = read(pipe_fds[0], buffer, HTMIN((size_t) left, sizeof(buffer)));
+	    if (n <= 0 || write_all(fd_out, buffer, n) < 0) {
+		/* do not leave data in the pipe for the next transfer */
+		close(pipe_fds[0]);
+		close(pipe_fds[1]);
+		pipe_fds[0] = pipe_fds[1] = -1;
+		return -1;
+	    }
+	}
+    }
+    return (int) result;
+}
+#endif /* HAVE_SPLICE */
+
+/*
+ *  Wait until a socket can be read, allowing for interrupts, then read it
+ *  into buf, or if fd_out is not -1, move the data to that file.
+ */
+static int HTDoReadInto(int fildes,
+			void *buf,
+			unsigned nbyte,
+			int fd_out GCC_UNUSED)
 {
     int result;
     BOOL ready;
@@ -2205,13 +2763,12 @@ int HTDoRead(int fildes,
 #if !defined(NO_IOCTL)
     int ret;
     fd_set readfds;
-    struct timeval select_timeout;
-    int tries = 0;
+    double began = HTTimeNow();
+    double now;
 
 #ifdef USE_READPROGRESS
-    int otries = 0;
-    time_t otime = time((time_t *) 0);
-    time_t start = otime;
+    double stalled = began;
+    time_t start = time((time_t *) 0);
 #endif
 #endif /* !NO_IOCTL */
 
@@ -2244,21 +2801,17 @@ int HTDoRead(int fildes,
 	/*
 	 * Protect against an infinite loop.
 	 */
-	if ((tries++ / TRIES_PER_SECOND) >= reading_timeout) {
+	now = HTTimeNow();
+	if (now - began >= reading_timeout) {
 	    HTAlert(gettext("Socket read failed (too many tries)."));
 	    SET_EINTR;
 	    result = HT_INTERRUPTED;
 	    break;
 	}
 #ifdef USE_READPROGRESS
-	if (tries - otries > TRIES_PER_SECOND) {
-	    time_t t = time((time_t *) 0);
-
-	    otries = tries;
-	    if (t - otime >= 5) {
-		otime = t;
-		HTReadProgress((off_t) (-1), (off_t) 0);	/* Put "stalled" message */
-	    }
+	if (now - stalled >= 5) {
+	    stalled = now;
+	    HTReadProgress((off_t) (-1), (off_t) 0);	/* Put "stalled" message */
 	}
 #endif
 
@@ -2266,19 +2819,10 @@ int HTDoRead(int fildes,
 	 * If we suspend, then it is possible that select will be interrupted.
 	 * Allow for this possibility.  - JED
 	 */
-	do {
-	    set_timeout(&select_timeout);
-	    FD_ZERO(&readfds);
-	    FD_SET((unsigned) fildes, &readfds);
-#ifdef SOCKS
-	    if (socks_flag)
-		ret = Rselect(fildes + 1,
-			      &readfds, NULL, NULL, &select_timeout);
-	    else
-#endif /* SOCKS */
-		ret = select(fildes + 1,
-			     &readfds, NULL, NULL, &select_timeout);
-	} while ((ret == -1) && (errno == EINTR));
+	FD_ZERO(&readfds);
+	FD_SET((unsigned) fildes, &readfds);
+	ret = wait_for_sockets(fildes + 1, &readfds, NULL,
+			       (long) ((began + reading_timeout - now) * 1000));
 
 	if (ret < 0) {
 	    result = -1;
@@ -2311,16 +2855,22 @@ int HTDoRead(int fildes,
 	}
 #else
 #ifdef UNIX
-	while ((result = (int) SOCKET_READ(fildes, buf, nbyte)) == -1) {
-	    if (errno == EINTR)
-		continue;
+#ifdef HAVE_SPLICE
+	if (fd_out != -1) {
+	    if ((result = splice_socket(fildes, fd_out, nbyte)) < 0)
+		HTInetStatus("splice");
+	} else
+#endif
+	    while ((result = (int) SOCKET_READ(fildes, buf, nbyte)) == -1) {
+		if (errno == EINTR)
+		    continue;
 #ifdef ERESTARTSYS
-	    if (errno == ERESTARTSYS)
-		continue;
+		if (errno == ERESTARTSYS)
+		    continue;
 #endif /* ERESTARTSYS */
-	    HTInetStatus("read");
-	    break;
-	}
+		HTInetStatus("read");
+		break;
+	    }
 #else /* UNIX */
 	result = SOCKET_READ(fildes, buf, nbyte);
 #endif /* !UNIX */
@@ -2334,6 +2884,28 @@ int HTDoRead(int fildes,
     return result;
 }
 
+/*
+ *  This is so interruptible reads can be implemented cleanly.
+ */
+int HTDoRead(int fildes,
+	     void *buf,
+	     unsigned nbyte)
+{
+    return HTDoReadInto(fildes, buf, nbyte, -1);
+}
+
+#ifdef HAVE_SPLICE
+/*
+ *  Like HTDoRead, but write the data to the file fd_out.
+ */
+int HTDoSplice(int fildes,
+	       int fd_out,
+	       unsigned nbyte)
+{
+    return HTDoReadInto(fildes, NULL, nbyte, fd_out);
+}
+#endif /* HAVE_SPLICE */
+
 #ifdef SVR4_BSDSELECT
 /*
  *  This is a fix for the difference between BSD's select() and
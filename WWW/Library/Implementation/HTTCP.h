@@ -101,6 +101,10 @@ extern "C" {
     extern LYNX_ADDRINFO *HTGetAddrInfo(const char *str, const int defport);
 #endif
 
+#ifdef NSL_FORK
+    extern void HTPrefetchHost(const char *url, int default_port);
+#endif
+
 /*      Get Name of This Machine
  *      ------------------------
  *
@@ -117,6 +121,12 @@ extern "C" {
 			void *buf,
 			unsigned nbyte);
 
+#ifdef HAVE_SPLICE
+    extern int HTDoSplice(int fildes,
+			  int fd_out,
+			  unsigned nbyte);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -469,6 +469,9 @@ static BOOL acceptEncoding(int code)
 	case encodingBZIP2:
 	    program = HTGetProgramPath(ppBZIP2);
 	    break;
+	case encodingZSTD:
+	    program = HTGetProgramPath(ppZSTD);
+	    break;
 	default:
 	    break;
 	}
@@ -682,6 +685,7 @@ static int HTLoadHTTP(const char *arg,
     }
     status = HTDoConnect(arg, "HTTP", HTTP_PORT, &s);
 #endif /* USE_SSL */
+    HTSetTimePhase(tpOther);
     if (status == HT_INTERRUPTED) {
 	/*
 	 * Interrupt cleanly.
@@ -736,7 +740,9 @@ static int HTLoadHTTP(const char *arg,
 #endif
 #endif /* SSLEAY_VERSION_NUMBER >= 0x0900 */
 	HTSSLInitPRNG();
+	HTSetTimePhase(tpTLS);
 	status = SSL_connect(handle);
+	HTSetTimePhase(tpOther);
 
 	if (status <= 0) {
 #if SSLEAY_VERSION_NUMBER >= 0x0900
@@ -1495,6 +1501,7 @@ static int HTLoadHTTP(const char *arg,
     }
 
     _HTProgress(gettext("Sending HTTP request."));
+    HTSetTimePhase(tpWait);
 
 #ifdef    NOT_ASCII		/* S/390 -- gil -- 0548 */
     {
@@ -1576,6 +1583,7 @@ static int HTLoadHTTP(const char *arg,
 				  line_buffer + length,
 				  (buffer_length - length - 1),
 				  handle);
+	    HTSetTimePhase(tpTransfer);
 	    CTRACE((tfp, "HTTP: Read %d\n", status));
 	    if (status <= 0) {
 		/*
@@ -2348,6 +2356,7 @@ static int HTLoadHTTP(const char *arg,
     /*
      * Recycle the first chunk of data, in all cases.
      */
+    HTSetTimePhase(tpRender);
     (*target->isa->put_block) (target, start_of_data, length);
 
     /*
@@ -359,6 +359,9 @@ Standard C library for malloc() etc
 #define NonNull(s) (((s) != 0) ? s : "")
 #define NONNULL(s) (((s) != 0) ? s : "(null)")
 
+/* memory used by a string, for reporting */
+#define StrMemory(s) ((s) != 0 ? (long) strlen(s) + 1 : 0)
+
 /* array/table size */
 #define	TABLESIZE(v)	(sizeof(v)/sizeof(v[0]))
 
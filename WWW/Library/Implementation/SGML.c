@@ -4240,6 +4240,53 @@ static void SGML_widechar(HTStream *me, int ch)
     }
 }
 
+/*
+ * Check if SGML_character() would pass plain ASCII text (other than '&' and
+ * '<') directly to the output without changing its state.  In that case, runs
+ * of such text can be written as a block.
+ */
+#ifdef EXP_JAPANESEUTF8_SUPPORT
+#define CanSkipJapanese(me) (!(me)->T.trans_to_uni)
+#else
+#define CanSkipJapanese(me) TRUE
+#endif
+
+#define CanSkipText(me) \
+	((me)->state == S_text \
+	 && !TRACE_SGML \
+	 && !IS_CJK_TTY \
+	 && CanSkipJapanese(me) \
+	 && (me)->slashedtag == NULL \
+	 && (me)->recover == NULL \
+	 && (me)->include == NULL \
+	 && (me)->active_include == NULL \
+	 && (me)->csi == NULL \
+	 && LYlowest_eightbit[(me)->inUCLYhndl] >= 127 \
+	 && !((me)->element_stack \
+	      && ((me)->element_stack->tag->flags & Tgf_frecyc)) \
+	 && !SkipTextForPrettySrc)
+
+#ifdef USE_PRETTYSRC
+#define SkipTextForPrettySrc psrc_view
+#else
+#define SkipTextForPrettySrc FALSE
+#endif
+
+/*
+ * Write a run of text found by UCAsciiSpan(), with the same effect as calling
+ * SGML_character() for each character.
+ */
+static void SGML_text_run(HTStream *me, const char *str, int len)
+{
+    sgml_offset += len;
+    if (me->T.decode_utf8) {
+	me->U.utf_count = 0;
+	me->U.utf_buf_p = me->U.utf_buf;
+    }
+    *(me->U.utf_buf) = '\0';
+    (*me->actions->put_block) (me->target, str, len);
+}
+
 static void SGML_write(HTStream *me, const char *str, int l)
 {
     const char *p;
@@ -4275,8 +4322,19 @@ static void SGML_write(HTStream *me, const char *str, int l)
 	    SGML_widechar(me, (UCH(p[0]) << 8) | UCH(p[1]));
 	break;
     default:
-	for (p = str; p < e; p++)
+	for (p = str; p < e; p++) {
+	    if (CanSkipText(me)) {
+		size_t n = UCAsciiSpan(p, (size_t) (e - p), '&', '<');
+
+		if (n != 0) {
+		    SGML_text_run(me, p, (int) n);
+		    p += n;
+		    if (p >= e)
+			break;
+		}
+	    }
 	    SGML_character(me, *p);
+	}
 	break;
     }
 }
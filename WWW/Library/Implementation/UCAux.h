@@ -61,6 +61,8 @@ extern "C" {
 
     extern dUTF8 HTDecodeUTF8(UTFDecodeState * me, int *c_in_out, UCode_t *result);
 
+    extern size_t UCAsciiSpan(const char *s, size_t len, int stop1, int stop2);
+
     extern void UCSetTransParams(UCTransParams * pT, int cs_in,
 				 const LYUCcharset *p_in,
 				 int cs_out,
@@ -0,0 +1,297 @@
+#!/usr/bin/perl -w
+# Measure how fast lynx renders a corpus of pages with -dump: the sample pages
+# in the test directory, and some generated ones which stress particular parts
+# of the parser and layout (huge tables, deep nesting, a large plain text file,
+# many entities, CJK text).  For each page, the best of several runs is shown,
+# along with the throughput after subtracting the time lynx takes to start up
+# on an empty page, and the peak RSS if GNU time is available.  If lynx has the
+# -timing option, the time of that run is split into the stages which it
+# reports: reading the page (transfer), laying it out (render) and the rest
+# (other, e.g., the dump itself).  Allocation counts are not measured.
+#
+# Usage: bench.pl [options] [lynx [lynx-options]]
+
+use strict;
+
+use Getopt::Std;
+use File::Basename;
+use File::Temp qw(tempdir);
+use Time::HiRes qw(gettimeofday tv_interval);
+
+our ( $opt_d, $opt_k, $opt_n, $opt_s, $opt_t );
+
+our $gnu_time;
+our $timing;
+our @stages = qw(transfer render other);
+
+sub usage() {
+	print <<EOF;
+Usage: bench.pl [options] [lynx [lynx-options]]
+
+Options:
+  -d DIR   directory of sample pages (default: test)
+  -k       keep the generated pages, showing where they are
+  -n N     time the best of N runs of each page (default: 3)
+  -s MB    size of the generated plain text page (default: 100)
+  -t NAME  only time pages whose name contains NAME
+EOF
+	exit 1;
+}
+
+sub write_page($$) {
+	my $name = $_[0];
+	my $text = $_[1];
+
+	open( my $fp, ">", $name ) || die "cannot create $name: $!";
+	binmode $fp, ":utf8";
+	print $fp $text;
+	close $fp;
+}
+
+sub html_page($$) {
+	my $title = $_[0];
+	my $body  = $_[1];
+
+	return <<EOF;
+<!DOCTYPE HTML PUBLIC "-//W3C//DTD HTML 4.01 Transitional//EN">
+<HTML>
+<HEAD>
+<TITLE>$title</TITLE>
+<META HTTP-EQUIV="Content-Type" CONTENT="text/html; charset=utf-8">
+</HEAD>
+<BODY>
+$body</BODY>
+</HTML>
+EOF
+}
+
+sub make_table($) {
+	my $dir  = $_[0];
+	my $body = "<TABLE BORDER=1>\n";
+
+	for my $row ( 1 .. 20000 ) {
+		$body .= "<TR>";
+		for my $col ( 1 .. 8 ) {
+			$body .= "<TD>row $row, col $col</TD>";
+		}
+		$body .= "</TR>\n";
+	}
+	$body .= "</TABLE>\n";
+	&write_page( "$dir/table.html", &html_page( "huge table", $body ) );
+}
+
+sub make_nesting($) {
+	my $dir   = $_[0];
+	my $depth = 2000;
+	my @tags  = qw(DIV UL BLOCKQUOTE DL);
+	my $body  = "";
+
+	for my $n ( 1 .. $depth ) {
+		my $tag = $tags[ $n % @tags ];
+		$body .= "<$tag>";
+		$body .= "<LI>" if ( $tag eq "UL" );
+		$body .= "<DD>" if ( $tag eq "DL" );
+		$body .= "level $n <A HREF=\"#l$n\">link</A>\n";
+	}
+	for my $n ( reverse 1 .. $depth ) {
+		$body .= "</" . $tags[ $n % @tags ] . ">\n";
+	}
+	&write_page( "$dir/nesting.html", &html_page( "deep nesting", $body ) );
+}
+
+sub make_plain($$) {
+	my $dir  = $_[0];
+	my $size = $_[1] * 1024 * 1024;
+	my $line = "The quick brown fox jumps over the lazy dog.  " x 2 . "\n";
+	my $block = $line x 1000;
+
+	open( my $fp, ">", "$dir/plain.txt" ) || die "cannot create plain.txt: $!";
+	for ( my $done = 0 ; $done < $size ; $done += length($block) ) {
+		print $fp $block;
+	}
+	close $fp;
+}
+
+sub make_entities($) {
+	my $dir = $_[0];
+	my @entities = (
+		"&amp;",   "&lt;",     "&gt;",    "&quot;",  "&nbsp;",   "&eacute;",
+		"&Uuml;",  "&szlig;",  "&copy;",  "&mdash;", "&hellip;", "&euro;",
+		"&#169;",  "&#x263A;", "&#8364;", "&alpha;", "&omega;",  "&rarr;"
+	);
+	my $body = "<P>\n";
+
+	for my $n ( 1 .. 50000 ) {
+		$body .= $entities[ $n % @entities ] . "x";
+		$body .= "\n" if ( $n % 20 == 0 );
+	}
+	&write_page( "$dir/entities.html", &html_page( "entities", $body ) );
+}
+
+sub make_cjk($) {
+	my $dir  = $_[0];
+	my $body = "";
+
+	for my $para ( 1 .. 2000 ) {
+		$body .= "<P>";
+		for my $n ( 0 .. 199 ) {
+			if ( $n % 7 == 0 ) {
+				$body .= chr( 0x3041 + ( ( $para + $n ) % 80 ) );
+			}
+			else {
+				$body .= chr( 0x4E00 + ( ( $para * 31 + $n ) % 20000 ) );
+			}
+		}
+		$body .= "\n";
+	}
+	&write_page( "$dir/cjk.html", &html_page( "CJK text", $body ) );
+}
+
+# Run lynx with its standard error going to the given file, returning the
+# result of system().
+sub run_logged($$) {
+	my @command = @{ $_[0] };
+	my $log     = $_[1];
+	my $rc;
+
+	open( my $save, ">&", \*STDERR ) || die "cannot dup stderr: $!";
+	open( STDERR, ">", $log ) || die "cannot create $log: $!";
+	$rc = system(@command);
+	open( STDERR, ">&", $save ) || die "cannot restore stderr: $!";
+	return $rc;
+}
+
+# Return the stage times from the summary line which -timing writes, e.g.,
+#	timing: documents=1 dns=0.000000 ... render=0.000659 other=0.008787 ...
+sub read_timing($) {
+	my $log = $_[0];
+	my %found;
+
+	if ( open( my $fp, "<", $log ) ) {
+		while (<$fp>) {
+			next unless (/^timing: documents=/);
+			%found = ();
+			while (/\b(\w+)=([\d.]+)/g) {
+				$found{$1} = $2;
+			}
+		}
+		close $fp;
+	}
+	return map { defined( $found{$_} ) ? $found{$_} : "-" } @stages;
+}
+
+sub run_lynx($$) {
+	my @lynx = @{ $_[0] };
+	my $page = $_[1];
+	my $log  = "$page.log";
+	my $best;
+	my @times = map { "-" } @stages;
+	my $rss   = "-";
+
+	for my $n ( 1 .. $opt_n ) {
+		my @command = ( @lynx, "-dump" );
+		push @command, "-timing" if ($timing);
+		my $start = [gettimeofday];
+		my $rc    = &run_logged( [ @command, $page ], $log );
+		my $took  = tv_interval($start);
+
+		die "cannot run $lynx[0]\n" if ( $rc == -1 );
+		if ( !defined($best) or $took < $best ) {
+			$best = $took;
+			@times = &read_timing($log) if ($timing);
+		}
+	}
+	unlink $log;
+	if ($gnu_time) {
+		my $out = "$page.rss";
+		system( $gnu_time, "-f", "%M", "-o", $out, @lynx, "-dump", $page );
+		if ( open( my $fp, "<", $out ) ) {
+			while (<$fp>) {
+				chomp;
+				$rss = $_ if (/^\d+$/);
+			}
+			close $fp;
+		}
+		unlink $out;
+	}
+	return ( $best, $rss, @times );
+}
+
+sub report($$$$$@) {
+	my $name    = shift;
+	my $bytes   = shift;
+	my $seconds = shift;
+	my $startup = shift;
+	my $rss     = shift;
+	my @times   = map { /^[\d.]+$/ ? sprintf( "%.3f", $_ ) : $_ } @_;
+	my $rate    = "-";
+
+	if ( $bytes > 0 and $seconds > $startup ) {
+		$rate = sprintf( "%.2f", $bytes / 1e6 / ( $seconds - $startup ) );
+	}
+	printf "%-24s %12d %9.3f %9s %9s %9s %9s %9s\n", $name, $bytes, $seconds,
+	  $rate, @times, $rss;
+}
+
+sub main() {
+	my @lynx = @ARGV;
+	my $dir  = tempdir( "lynx-bench-XXXXXX", TMPDIR => 1, CLEANUP => !$opt_k );
+	my @pages;
+
+	@lynx = ("lynx") unless (@lynx);
+	$opt_d = "test" unless ( defined $opt_d );
+	$opt_n = 3      unless ( defined $opt_n and $opt_n > 0 );
+	$opt_s = 100    unless ( defined $opt_s );
+
+	foreach my $path ( "/usr/bin/time", "/bin/time" ) {
+		if ( -x $path and system("$path -f %M true >/dev/null 2>&1") == 0 ) {
+			$gnu_time = $path;
+			last;
+		}
+	}
+
+	# the dumps are discarded; only the time they take matters
+	open( my $save, ">&", \*STDOUT ) || die "cannot dup stdout: $!";
+
+	&write_page( "$dir/empty.html", "" );
+	open( STDOUT, ">", "/dev/null" ) || die "cannot redirect stdout: $!";
+	&run_logged( [ @lynx, "-dump", "-timing", "$dir/empty.html" ],
+		"$dir/empty.log" );
+	$timing = ( &read_timing("$dir/empty.log") )[0] ne "-";
+	unlink "$dir/empty.log";
+	open( STDOUT, ">&", $save ) || die "cannot restore stdout: $!";
+
+	&make_table($dir);
+	&make_nesting($dir);
+	&make_plain( $dir, $opt_s );
+	&make_entities($dir);
+	&make_cjk($dir);
+	printf STDERR "generated pages are in %s\n", $dir if ($opt_k);
+
+	push @pages, sort glob("$opt_d/*.html") if ( -d $opt_d );
+	push @pages, map { "$dir/$_" }
+	  qw(table.html nesting.html plain.txt entities.html cjk.html);
+	@pages = grep { index( basename($_), $opt_t ) >= 0 } @pages
+	  if ( defined $opt_t );
+
+	open( STDOUT, ">", "/dev/null" ) || die "cannot redirect stdout: $!";
+	my ( $startup, @startup_rest ) = &run_lynx( \@lynx, "$dir/empty.html" );
+	my @results;
+	foreach my $page (@pages) {
+		push @results, [ $page, &run_lynx( \@lynx, $page ) ];
+	}
+	open( STDOUT, ">&", $save ) || die "cannot restore stdout: $!";
+
+	printf "%-24s %12s %9s %9s %9s %9s %9s %9s\n", "page", "bytes", "seconds",
+	  "MB/s", @stages, "maxrss/kB";
+	&report( "(startup)", 0, $startup, $startup, @startup_rest );
+	foreach my $result (@results) {
+		my ( $page, $seconds, @rest ) = @$result;
+		&report( basename($page), -s $page, $seconds, $startup, @rest );
+	}
+}
+
+&usage() unless getopts('d:kn:s:t:');
+&main();
+
+1;
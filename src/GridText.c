@@ -69,7 +69,29 @@
 #  define WRAP_COLS(text) LYcolLimit
 #endif
 
+/*
+ * Where to split lines.  That is WRAP_COLS, except for the rows of a simple
+ * table which we will wrap when the table ends (see HText_wrapStblLines).
+ */
+#define SPLIT_COLS(text) (((text)->stbl && Stbl_wrapCells())	\
+			  ? MAX_COLS - 1				\
+			  : WRAP_COLS(text))
+
 #define FirstHTLine(text) ((text)->last_line->next)
+
+/*
+ * Remember how close the layout came to the right margin in the comparisons
+ * which decide where to wrap lines.  Unless the layout used the screen width
+ * in some other way (uses_width), another width for which this stays below
+ * the margin would give the same layout.  The slack covers the differences
+ * between those comparisons, which are made against LYcols less one or two.
+ */
+#define NoteExtent(text, extent) \
+	do { \
+	    if ((extent) > (text)->widest) \
+		(text)->widest = (extent); \
+	} while (0)
+#define EXTENT_SLACK 4
 #define LastHTLine(text)  ((text)->last_line)
 
 static void HText_trimHightext(HText *text, int final, int stop_before);
@@ -79,7 +101,7 @@ static void HText_trimHightext(HText *text, int final, int stop_before);
 
 #define IS_UTF8_EXTRA(ch) (!(text && text->T.output_utf8) || \
 			  !is8bits(ch) || \
-			  (UCH(line->data[i] & 0xc0) == 0xc0))
+			  (UCH((ch) & 0xc0) == 0xc0))
 
 /* a test in compact form: how many extra UTF-8 chars after initial? - kw */
 #define UTF8_XNEGLEN(c) (c&0xC0? 0 :c&32? 1 :c&16? 2 :c&8? 3 :c&4? 4 :c&2? 5:0)
@@ -315,6 +337,8 @@ typedef struct _line {
     HTStyleChange *styles;
     unsigned short numstyles;
 #endif
+    unsigned short width_size;	/* Number of characters counted in width */
+    unsigned short width;	/* HText_TrueLineSize() of that much data */
     char data[1];		/* Space for terminator at least! */
 } HTLine;
 
@@ -350,6 +374,13 @@ typedef struct {
 
 #define TEMP_LINE(p,n) ((HTLine *)&(p->temp_line[n]))
 
+/*
+ * The width of a line is counted as it grows, and only the characters added
+ * since the last count are scanned.  Anything which removes or replaces
+ * characters of the line must discard the count.
+ */
+#define ForgetLineWidth(line) (line)->width_size = (line)->width = 0
+
 typedef struct _TextAnchor {
     struct _TextAnchor *next;
     struct _TextAnchor *prev;	/* www_user_search only! */
@@ -367,8 +398,27 @@ typedef struct _TextAnchor {
     HiliteList lites;
 
     HTChildAnchor *anchor;
+    struct _TextAnchor *next_unique;	/* chain in text->unique_hash */
 } TextAnchor;
 
+typedef struct {
+    int offset;			/* sgml_offset of an anchor */
+    int seq;			/* ...its position in the anchor list */
+} AnchorOffset;
+
+/*
+ * An index of the anchors of a complete document, so they can be found by
+ * number, by offset in the source or by line without walking the list.
+ */
+typedef struct {
+    int count;			/* number of anchors */
+    TextAnchor **list;		/* the anchors in list order */
+    BOOL lines_sorted;		/* list is also in line_num order */
+    int max_number;		/* largest a->number */
+    TextAnchor **by_number;	/* first anchor with each number */
+    AnchorOffset *by_offset;	/* sorted by sgml_offset, then seq */
+} AnchorTable;
+
 typedef struct {
     char *name;			/* ID value of TAB */
     int column;			/* Zero-based column value */
@@ -425,6 +475,7 @@ struct _HText {
     int last_anchor_number;	/* user number */
     BOOL source;		/* Is the text source? */
     BOOL toolbar;		/* Toolbar set? */
+    char *next_link;		/* LINK REL="Next" */
     HTList *tabs;		/* TAB IDs */
     HTList *hidden_links;	/* Content-less links ... */
     int hiddenlinkflag;		/*  ... and how to treat them */
@@ -444,6 +495,11 @@ struct _HText {
     BOOL has_utf8;		/* has utf-8 on screen or line */
     BOOL had_utf8;		/* had utf-8 when last displayed */
     int next_number;		/* next a->number value */
+    TextAnchor **unique_hash;	/* for -unique-urls, by address and tag */
+    unsigned unique_size;	/* ...number of its chains */
+    unsigned unique_count;	/* ...number of anchors in it */
+    AnchorTable *anchor_table;	/* built on demand once text is complete */
+    BOOL anchors_complete;	/* HText_endAppend was called */
 #ifdef DISP_PARTIAL
     int first_lineno_last_disp_partial;
     int last_lineno_last_disp_partial;
@@ -464,6 +520,9 @@ struct _HText {
     int halted;			/* emergency halt */
 
     BOOL have_8bit_chars;	/* Any non-ASCII chars? */
+    BOOL has_images;		/* Any images, objects, etc.? */
+    BOOL uses_width;		/* Layout depends on the screen width? */
+    int widest;			/* ...else how near it came to the margin */
     LYUCcharset *UCI;		/* node_anchor UCInfo */
     int UCLYhndl;		/* charset we are fed */
     UCTransParams T;
@@ -919,16 +978,15 @@ static void free_form_fields(FormInfo * input_field)
 	 * and left the input field in an insane state.  - kw
 	 */
 	OptionType *optptr = input_field->select_list;
-	OptionType *tmp;
 
 	while (optptr) {
-	    tmp = optptr;
-	    optptr = tmp->next;
-	    FREE(tmp->name);
-	    FREE(tmp->cp_submit_value);
-	    FREE(tmp);
+	    FREE(optptr->name);
+	    FREE(optptr->cp_submit_value);
+	    optptr = optptr->next;
 	}
 	input_field->select_list = NULL;
+	input_field->select_last = NULL;
+	FREE(input_field->select_names);
 	/*
 	 * Don't free the value field on option
 	 * lists since it points to a option value
@@ -1219,6 +1277,102 @@ HText *HText_new2(HTParentAnchor *anchor,
     return result;
 }
 
+static void free_anchor_table(HText *text)
+{
+    AnchorTable *table = text->anchor_table;
+
+    if (table != 0) {
+	FREE(table->list);
+	FREE(table->by_number);
+	FREE(table->by_offset);
+	FREE(text->anchor_table);
+    }
+}
+
+static int compare_offsets(const void *a, const void *b)
+{
+    const AnchorOffset *p = (const AnchorOffset *) a;
+    const AnchorOffset *q = (const AnchorOffset *) b;
+
+    if (p->offset != q->offset)
+	return (p->offset < q->offset) ? -1 : 1;
+    return (p->seq - q->seq);
+}
+
+/*
+ * Return the anchor table for the text, building it if the text is complete.
+ * Functions which add anchors or renumber them after that discard the table
+ * with free_anchor_table(), so that it is rebuilt when next needed.  While
+ * building it, fill in the 'prev' pointers used in www_search_backward().
+ */
+static AnchorTable *get_anchor_table(HText *text)
+{
+    AnchorTable *table;
+    TextAnchor *a;
+    TextAnchor *prev = 0;
+    int n;
+
+    if (text == 0 || !text->anchors_complete)
+	return 0;
+    if (text->anchor_table != 0)
+	return text->anchor_table;
+
+    if ((table = typecalloc(AnchorTable)) == 0)
+	outofmem(__FILE__, "get_anchor_table");
+
+    for (a = text->first_anchor; a != 0; a = a->next) {
+	++(table->count);
+	if (a->number > table->max_number)
+	    table->max_number = a->number;
+    }
+    table->list = typecallocn(TextAnchor *, (size_t) table->count + 1);
+    table->by_number = typecallocn(TextAnchor *, (size_t) table->max_number + 1);
+    table->by_offset = typecallocn(AnchorOffset, (size_t) table->count + 1);
+    if (table->list == 0
+	|| table->by_number == 0
+	|| table->by_offset == 0)
+	outofmem(__FILE__, "get_anchor_table");
+
+    table->lines_sorted = TRUE;
+    for (n = 0, a = text->first_anchor; a != 0; a = a->next, ++n) {
+	table->list[n] = a;
+	if (a->number > 0 && table->by_number[a->number] == 0)
+	    table->by_number[a->number] = a;
+	table->by_offset[n].offset = a->sgml_offset;
+	table->by_offset[n].seq = n;
+	if (prev != 0 && prev->line_num > a->line_num)
+	    table->lines_sorted = FALSE;
+	a->prev = prev;
+	prev = a;
+    }
+    qsort(table->by_offset, (size_t) table->count,
+	  sizeof(AnchorOffset), compare_offsets);
+
+    CTRACE((tfp, "GridText: indexed %d anchors\n", table->count));
+    text->anchor_table = table;
+    return table;
+}
+
+/*
+ * Return the position of the first entry in the table whose sgml_offset is
+ * not less than the given offset.
+ */
+static int offset_in_table(AnchorTable *table, int offset)
+{
+    int lo = 0;
+    int hi = table->count;
+
+    while (lo < hi) {
+	int mid = (lo + hi) / 2;
+
+	if (table->by_offset[mid].offset < offset)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    return lo;
+}
+
 /*	Free Entire Text
  *	----------------
  */
@@ -1253,6 +1407,9 @@ void HText_free(HText *self)
 	LYFreeHiText(l);
     }
     FormList_delete(self->forms);
+    FREE(self->unique_hash);
+    FREE(self->next_link);
+    free_anchor_table(self);
 
     /*
      * Free the tabs list.  -FM
@@ -2503,7 +2660,7 @@ void HText_beginAppend(HText *text)
 #define LYcols_cu(text) (dump_output_immediately ? MAX_COLS : SLtt_Screen_Cols)
 #else
 #ifdef WIDEC_CURSES
-#define LYcols_cu(text) WRAP_COLS(text)
+#define LYcols_cu(text) SPLIT_COLS(text)
 #else
 #define LYcols_cu(text) (dump_output_immediately ? MAX_COLS : DISPLAY_COLS)
 #endif
@@ -2729,6 +2886,7 @@ static HTLine *insert_blanks_in_line(HTLine *line, int line_number,
     }
     *t = '\0';
     mod_line->size = (unsigned short) (t - newdata);
+    ForgetLineWidth(mod_line);
     return mod_line;
 }
 
@@ -2919,6 +3077,7 @@ static void split_line(HText *text, unsigned split)
 	/* Split the line. -FM */
 	prevdata[previous->size] = '\0';
 	previous->size = (unsigned short) split;
+	ForgetLineWidth(previous);
 
 	/*
 	 * Trim any spaces or soft hyphens from the beginning
@@ -2997,6 +3156,7 @@ static void split_line(HText *text, unsigned split)
     /*  Strip trailers. */
     TailTrim = (int) (previous->data + previous->size - 1 - p);
     previous->size = (unsigned short) (previous->size - TailTrim);
+    ForgetLineWidth(previous);
     p[1] = '\0';
 
     /*
@@ -3167,6 +3327,7 @@ static void split_line(HText *text, unsigned split)
 	   (alignment == HT_CENTER ||
 	    alignment == HT_RIGHT) || text->stbl) {
 	/* Calculate spare character positions if needed */
+	text->uses_width = TRUE;
 	for (cp = previous->data; *cp; cp++) {
 	    if (*cp == LY_UNDERLINE_START_CHAR ||
 		*cp == LY_UNDERLINE_END_CHAR ||
@@ -4075,14 +4236,17 @@ void HText_appendCharacter(HText *text, int ch)
 	 * to the line here and return.  - kw
 	 */
 	if (IS_UTF_EXTRA(ch)) {
+	    int extent = (indent + (int) (line->offset + line->size)
+			  + UTFXTRA_ON_THIS_LINE
+			  - ctrl_chars_on_this_line
+			  + ((line->size > 0) &&
+			     (int) (line->data[line->size - 1] ==
+				    LY_SOFT_HYPHEN ?
+				    1 : 0)));
+
+	    NoteExtent(text, extent);
 	    if ((line->size > (MAX_LINE - 1))
-		|| (indent + (int) (line->offset + line->size)
-		    + UTFXTRA_ON_THIS_LINE
-		    - ctrl_chars_on_this_line
-		    + ((line->size > 0) &&
-		       (int) (line->data[line->size - 1] ==
-			      LY_SOFT_HYPHEN ?
-			      1 : 0)) >= LYcols_cu(text))
+		|| (extent >= LYcols_cu(text))
 		) {
 		if (!text->permissible_split || text->source) {
 		    text->permissible_split = line->size;
@@ -4189,6 +4353,7 @@ void HText_appendCharacter(HText *text, int ch)
 	     * if one does, we'll dump the soft hyphen.  -FM
 	     */
 	    line->data[--line->size] = '\0';
+	    ForgetLineWidth(line);
 	    ctrl_chars_on_this_line--;
 	}
 	here = ((int) (line->size + line->offset) + indent)
@@ -4226,7 +4391,8 @@ void HText_appendCharacter(HText *text, int ch)
 	else
 	    target_cu = target + (here_cu - here);
 
-	if (target > WRAP_COLS(text) - (int) style->rightIndent &&
+	NoteExtent(text, target + (int) style->rightIndent);
+	if (target > SPLIT_COLS(text) - (int) style->rightIndent &&
 	    HTOutputFormat != WWW_SOURCE) {
 	    new_line(text);
 	} else {
@@ -4234,8 +4400,8 @@ void HText_appendCharacter(HText *text, int ch)
 	     * Can split here.  -FM
 	     */
 	    text->permissible_split = line->size;
-	    if (target_cu > WRAP_COLS(text))
-		target -= target_cu - WRAP_COLS(text);
+	    if (target_cu > SPLIT_COLS(text))
+		target -= target_cu - SPLIT_COLS(text);
 	    if (line->size == 0) {
 		line->offset = (unsigned short) (line->offset + (target - here));
 	    } else {
@@ -4258,6 +4424,8 @@ void HText_appendCharacter(HText *text, int ch)
 	int target = (int) (line->offset + line->size) - ctrl_chars_on_this_line;
 	int target_cu = target + UTFXTRA_ON_THIS_LINE;
 
+	NoteExtent(text, target + style->rightIndent);
+	NoteExtent(text, target_cu + UTF_XLEN(ch));
 	if (target >= WRAP_COLS(text) - style->rightIndent -
 	    ((IS_CJK_TTY && text->kanji_buf) ? 1 : 0) ||
 	    (text->T.output_utf8 &&
@@ -4313,6 +4481,8 @@ void HText_appendCharacter(HText *text, int ch)
 	       (int) (line->data[line->size - 1] == LY_SOFT_HYPHEN ? 1 : 0))
 	      - ctrl_chars_on_this_line);
 
+    NoteExtent(text, actual + (int) style->rightIndent);
+    NoteExtent(text, actual + UTFXTRA_ON_THIS_LINE + UTF_XLEN(ch));
     if (((text->permissible_split
 #ifdef USE_CURSES_PADS
 	  || !LYwideLines
@@ -4320,7 +4490,7 @@ void HText_appendCharacter(HText *text, int ch)
 	 ) && (actual
 	       + (int) style->rightIndent
 	       + ((IS_CJK_TTY && text->kanji_buf) ? 1 : 0)
-	 ) >= WRAP_COLS(text))
+	 ) >= SPLIT_COLS(text))
 	|| (text->T.output_utf8
 	    && ((actual
 		 + UTFXTRA_ON_THIS_LINE
@@ -4588,6 +4758,755 @@ char HText_getLastChar(HText *text)
  *		-------------------------------
  */
 
+/*
+ * When dumping, simple tables are laid out in two passes.  While a table is
+ * collected, its rows are not wrapped at the screen width (see SPLIT_COLS),
+ * so that the simple table code measures each column on a single line.  When
+ * the table ends, HText_insertBlanksInStblLines aligns the columns as usual,
+ * and if the result is too wide, wraps the cells into narrower columns.  Each
+ * column gets room for its longest word, and the rest of the width is shared
+ * in proportion to the remaining content of the columns.  Tables which do not
+ * have each row on a single line, or whose longest words do not fit side by
+ * side, are wrapped line by line instead.  Cells are broken only at blanks or
+ * next to wide characters, never inside a word or form field.  Widths are
+ * measured in cells, not characters.  A row which takes several lines is set
+ * off from the others by an empty line.
+ */
+#define STBL_GUTTER 1		/* blanks between wrapped columns */
+#define STBL_MIN_WRAP 10	/* do not wrap lines narrower than this */
+
+#define ATTR_UNDERLINE 1
+#define ATTR_BOLD      2
+
+typedef struct {
+    const char *text;		/* the cell's data, without blanks around it */
+    const char *end;
+    int attrs;			/* underline/bold which are on at 'text' */
+    int col;			/* column of the cell in the wrapped lines */
+    int width;			/* ...and the room it has there */
+    int span;
+    int alignment;
+} StblCell;
+
+static short stbl_map_line[MAX_LINE + 1];	/* wrapped line of each byte */
+static short stbl_map_pos[MAX_LINE + 1];	/* ...and its offset there */
+static char stbl_field[MAX_LINE + 1];	/* bytes of form fields on a line */
+
+#define StblInField(line, s) ((line) != NULL \
+			      && (s) - (line)->data <= MAX_LINE \
+			      && stbl_field[(s) - (line)->data])
+
+static int stbl_attrs(int attrs, int ch)
+{
+    switch (ch) {
+    case LY_UNDERLINE_START_CHAR:
+	attrs |= ATTR_UNDERLINE;
+	break;
+    case LY_UNDERLINE_END_CHAR:
+	attrs &= ~ATTR_UNDERLINE;
+	break;
+    case LY_BOLD_START_CHAR:
+	attrs |= ATTR_BOLD;
+	break;
+    case LY_BOLD_END_CHAR:
+	attrs &= ~ATTR_BOLD;
+	break;
+    }
+    return attrs;
+}
+
+/*
+ * Return the number of cells used by the character which begins at 's'.
+ * LYstrExtent2 would ask curses, which is not started when dumping, so look
+ * for the East Asian wide characters here.
+ */
+static int stbl_char_cells(HText *text, const char *s)
+{
+    if (text->T.output_utf8 && UCH(*s) >= 0xC0) {
+	const char *p = s;
+	UCode_t code = UCGetUniFromUtf8String(&p);
+
+	if ((code >= 0x1100 && code <= 0x115F)
+	    || (code >= 0x2E80 && code <= 0xA4CF && code != 0x303F)
+	    || (code >= 0xAC00 && code <= 0xD7A3)
+	    || (code >= 0xF900 && code <= 0xFAFF)
+	    || (code >= 0xFE30 && code <= 0xFE4F)
+	    || (code >= 0xFF00 && code <= 0xFF60)
+	    || (code >= 0xFFE0 && code <= 0xFFE6)
+	    || (code >= 0x20000 && code <= 0x3FFFD))
+	    return 2;
+    }
+    return 1;
+}
+
+/*
+ * Mark the bytes of a line which belong to form fields, given the first
+ * anchor which may be on the line.  Returns true if there are any.
+ */
+static BOOL stbl_find_fields(HTLine *line, int lineno, TextAnchor *a)
+{
+    BOOL found = FALSE;
+    int limit = HTMIN((int) line->size, MAX_LINE);
+
+    memset(stbl_field, 0, (size_t) limit + 1);
+    for (; a && a->line_num <= lineno; a = a->next) {
+	if (a->line_num == lineno
+	    && a->link_type == INPUT_ANCHOR
+	    && a->extent > 0) {
+	    int start = HTMIN(HTMAX(a->line_pos, 0), limit);
+	    int end = HTMIN(start + a->extent, limit);
+
+	    if (start < end) {
+		memset(stbl_field + start, 1, (size_t) (end - start));
+		found = TRUE;
+	    }
+	}
+    }
+    return found;
+}
+
+/*
+ * Return the number of cells between s and e on the line, and the width of
+ * the longest word there.  A form field counts as one word, and so does each
+ * wide character, since lines may be broken between those.
+ */
+static int stbl_data_width(HText *text, HTLine *line, const char *s,
+			   const char *e,
+			   int *longest)
+{
+    int width = 0;
+    int word = 0;
+
+    *longest = 0;
+    for (; s < e; ++s) {
+	if (*s == ' ' && !StblInField(line, s)) {
+	    word = 0;
+	    ++width;
+	} else if (!IsSpecialAttrChar(*s) && IS_UTF8_EXTRA(*s)) {
+	    int cells = stbl_char_cells(text, s);
+
+	    if (cells > 1)
+		word = 0;
+	    width += cells;
+	    word += cells;
+	    if (word > *longest)
+		*longest = word;
+	    if (cells > 1)
+		word = 0;
+	}
+    }
+    return width;
+}
+
+/*
+ * Return the width in cells of the widest line of a table.
+ */
+static int stbl_widest_line(HText *me, HTLine *line, int lineno,
+			    int last_lineno)
+{
+    int result = 0;
+    int longest;
+
+    for (; line && lineno <= last_lineno && line != me->last_line;
+	 line = line->next, lineno++) {
+	int width = (int) line->offset + stbl_data_width(me, NULL, line->data,
+							 line->data + line->size,
+							 &longest);
+
+	if (width > result)
+	    result = width;
+    }
+    return result;
+}
+
+/*
+ * Find the cells of a row, given the positions where the columns begin on
+ * its line.  The leading and trailing blanks of each cell are dropped, as
+ * well as formatting characters there, remembering their effect in 'attrs'.
+ */
+static void stbl_find_cells(HText *text, HTLine *line, StblCell *cells,
+			    int ncells, const int *colpos)
+{
+    const char *s = line->data;
+    const char *pre = s;
+    const char *last = line->data + line->size;
+    int n = 0;			/* count displayed characters */
+    int attrs = 0;
+    int ic;
+
+    for (ic = 0; ic < ncells; ++ic) {
+	StblCell *cell = &cells[ic];
+	int limit;
+	const char *start;
+	const char *end;
+
+	/*
+	 * Find the start and end of the cell, as insert_blanks_in_line would:
+	 * stop before the formatting characters which precede its position.
+	 */
+	limit = colpos[cell->col];
+	while (s < last) {
+	    if (text->T.output_utf8
+		&& UCH(*s) >= 0x80 && UCH(*s) < 0xC0) {
+		pre = s + 1;
+	    } else if (!IsSpecialAttrChar(*s)) {
+		if (n >= limit)
+		    break;
+		n++;
+		pre = s + 1;
+	    }
+	    s++;
+	}
+	start = (s < last) ? pre : last;
+	for (s = pre; s < start; ++s)
+	    attrs = stbl_attrs(attrs, *s);
+	if (ic + 1 < ncells) {
+	    limit = colpos[cell->col + cell->span];
+	    while (s < last) {
+		if (text->T.output_utf8
+		    && UCH(*s) >= 0x80 && UCH(*s) < 0xC0) {
+		    pre = s + 1;
+		} else if (!IsSpecialAttrChar(*s)) {
+		    if (n >= limit)
+			break;
+		    n++;
+		    pre = s + 1;
+		}
+		s++;
+	    }
+	    end = (s < last) ? pre : last;
+	} else {
+	    end = last;
+	}
+
+	/*
+	 * Trim blanks and formatting characters.
+	 */
+	while (start < end && (*start == ' ' || IsSpecialAttrChar(*start)))
+	    attrs = stbl_attrs(attrs, *start++);
+	cell->text = start;
+	cell->end = start;
+	cell->attrs = attrs;
+	for (s = start; s < end; ++s) {
+	    attrs = stbl_attrs(attrs, *s);
+	    if (*s != ' ' && !IsSpecialAttrChar(*s))
+		cell->end = s + 1;
+	}
+	while (cell->end < end
+	       && text->T.output_utf8
+	       && UCH(*cell->end) >= 0x80 && UCH(*cell->end) < 0xC0)
+	    cell->end++;
+	s = pre = end;
+    }
+}
+
+/*
+ * Find the part of a cell which fits in its width, and in 'limit' bytes, and
+ * return its end.  Set 'next' to where the following part begins.  Lines are
+ * broken at blanks, or next to wide characters.  A word which is too long
+ * for the cell is not broken, but left to run past its width.  Blanks in form
+ * fields do not count, so those are not broken either.
+ */
+static const char *stbl_next_segment(HText *text, HTLine *line,
+				     StblCell *cell,
+				     int limit,
+				     const char **next,
+				     int *width)
+{
+    const char *s = cell->text;
+    const char *brk = NULL;	/* the last place which we could break at */
+    int brk_width = 0;
+    int n = 0;
+    BOOL wide = FALSE;		/* the last character was a wide one */
+
+    for (; s < cell->end; ++s) {
+	if (n > 0 && (s - cell->text) >= limit)
+	    break;
+	if (*s == ' ' && !StblInField(line, s)) {
+	    if (n > cell->width)
+		break;
+	    if (brk == NULL || s[-1] != ' ') {
+		brk = s;
+		brk_width = n;
+	    }
+	    wide = FALSE;
+	    ++n;
+	} else if (!IsSpecialAttrChar(*s) && IS_UTF8_EXTRA(*s)) {
+	    int cells = stbl_char_cells(text, s);
+
+	    if (n > 0 && (wide || cells > 1)) {
+		brk = s;
+		brk_width = n;
+	    }
+	    if (n + cells > cell->width && brk != NULL)
+		break;
+	    wide = (BOOL) (cells > 1);
+	    n += cells;
+	}
+    }
+    if (s >= cell->end) {
+	*next = cell->end;
+	*width = n;
+	return cell->end;
+    }
+    if (brk != NULL) {
+	*next = brk;
+	*width = brk_width;
+	return brk;
+    }
+    *next = s;
+    *width = n;
+    return s;
+}
+
+/*
+ * Replace the given line with the lines needed to wrap its cells, and fix
+ * the anchors on it.  Returns the number of lines which replace it.
+ */
+static int stbl_wrap_line(HText *me, HTLine *line, int new_lineno,
+			  StblCell *cells, int ncells,
+			  TextAnchor **prev_anchor,	/*updates++ */
+			  int lineno)
+{
+    char buffer[2 * MAX_LINE];
+    HTLine *first = NULL;
+    HTLine *last = NULL;
+    HTLine *mod_line;
+    TextAnchor *a;
+    int nlines = 0;
+    int i, ic;
+    int map_line, map_pos;
+
+    for (i = 0; i <= (int) line->size; ++i)
+	stbl_map_line[i] = -1;
+
+    for (;;) {
+	BOOL any = FALSE;
+	int len = 0;
+	int col = 0;
+
+	for (ic = 0; ic < ncells; ++ic) {
+	    StblCell *cell = &cells[ic];
+	    const char *s;
+	    const char *end;
+	    const char *next;
+	    int width, start;
+
+	    if (cell->text >= cell->end)
+		continue;
+	    any = TRUE;
+	    end = stbl_next_segment(me, line, cell,
+				    MAX_LINE - 6 - len - (cell->col - col),
+				    &next, &width);
+	    start = cell->col;
+	    if (cell->alignment == HT_RIGHT)
+		start += HTMAX(cell->width - width, 0);
+	    else if (cell->alignment == HT_CENTER)
+		start += HTMAX(cell->width - width, 0) / 2;
+	    for (; col < start; ++col)
+		buffer[len++] = ' ';
+	    col = start + width;
+	    if (cell->attrs & ATTR_UNDERLINE)
+		buffer[len++] = LY_UNDERLINE_START_CHAR;
+	    if (cell->attrs & ATTR_BOLD)
+		buffer[len++] = LY_BOLD_START_CHAR;
+	    for (s = cell->text; s < end; ++s) {
+		stbl_map_line[s - line->data] = (short) nlines;
+		stbl_map_pos[s - line->data] = (short) len;
+		buffer[len++] = *s;
+		cell->attrs = stbl_attrs(cell->attrs, *s);
+	    }
+	    if (cell->attrs & ATTR_BOLD)
+		buffer[len++] = LY_BOLD_END_CHAR;
+	    if (cell->attrs & ATTR_UNDERLINE)
+		buffer[len++] = LY_UNDERLINE_END_CHAR;
+	    for (s = next; s < cell->end && (*s == ' ' || IsSpecialAttrChar(*s));
+		 ++s) {
+		cell->attrs = stbl_attrs(cell->attrs, *s);
+	    }
+	    for (; end < next; ++end)
+		cell->attrs = stbl_attrs(cell->attrs, *end);
+	    cell->text = s;
+	}
+	if (!any && nlines > 0)
+	    break;
+
+	allocHTLine(mod_line, (unsigned) len);
+	if (!mod_line)
+	    outofmem(__FILE__, "stbl_wrap_line");
+	assert(mod_line != NULL);
+	mod_line->offset = line->offset;
+	mod_line->size = (unsigned short) len;
+	memcpy(mod_line->data, buffer, (size_t) len);
+	mod_line->data[len] = '\0';
+	if (last != NULL) {
+	    last->next = mod_line;
+	    mod_line->prev = last;
+	} else {
+	    first = mod_line;
+	}
+	last = mod_line;
+	nlines++;
+	if (!any)
+	    break;
+    }
+
+    /*
+     * Bytes which were dropped are mapped to the next one which was kept.
+     */
+    map_line = nlines - 1;
+    map_pos = last->size;
+    for (i = (int) line->size; i >= 0; --i) {
+	if (stbl_map_line[i] < 0) {
+	    stbl_map_line[i] = (short) map_line;
+	    stbl_map_pos[i] = (short) map_pos;
+	} else {
+	    map_line = stbl_map_line[i];
+	    map_pos = stbl_map_pos[i];
+	}
+    }
+
+    /*
+     * Anchors which continued past a break now end there, since the next
+     * line holds the other cells.
+     */
+    for (a = *prev_anchor; a && a->line_num == lineno; a = a->next) {
+	int start = HTMIN(HTMAX(a->line_pos, 0), (int) line->size);
+	int end = HTMIN(start + HTMAX(a->extent, 0), (int) line->size);
+	int extent = 0;
+
+	if (end > start) {
+	    HTLine *l = first;
+
+	    for (i = 0; i < stbl_map_line[start]; ++i)
+		l = l->next;
+	    if (stbl_map_line[end - 1] == stbl_map_line[start])
+		extent = stbl_map_pos[end - 1] + 1 - stbl_map_pos[start];
+	    else
+		extent = l->size - stbl_map_pos[start];
+	}
+	a->line_num = new_lineno + stbl_map_line[start];
+	a->line_pos = stbl_map_pos[start];
+	a->extent = (short) HTMAX(extent, 0);
+    }
+    *prev_anchor = a;
+
+    first->prev = line->prev;
+    last->next = line->next;
+    line->prev->next = first;
+    line->next->prev = last;
+    freeHTLine(me, line);
+
+    return nlines;
+}
+
+/*
+ * Insert an empty line after the given one.
+ */
+static void stbl_insert_blank(HTLine *after)
+{
+    HTLine *blank;
+
+    allocHTLine(blank, 0);
+    if (!blank)
+	outofmem(__FILE__, "stbl_insert_blank");
+    assert(blank != NULL);
+    blank->offset = 0;
+    blank->size = 0;
+    blank->data[0] = '\0';
+    blank->prev = after;
+    blank->next = after->next;
+    after->next->prev = blank;
+    after->next = blank;
+}
+
+/*
+ * Wrap the lines of a table, from 'line' (numbered 'lineno') to 'last_lineno'.
+ * If 'colstart' is given, it is where each column begins in the wrapped lines,
+ * and all of the rows are wrapped into those columns.  Otherwise, wrap just
+ * the lines which are too wide.  A row which takes several lines is separated
+ * from its neighbors by an empty line.  Returns the number of lines added.
+ */
+static int HText_wrapStblLines(HText *me, HTLine *line, int lineno,
+			       int last_lineno,
+			       TextAnchor *before,
+			       int ncols,
+			       int *colstart)
+{
+    TextAnchor *a = (before != NULL) ? before : me->first_anchor;
+    StblCell *cells;
+    int *cols, *spans, *aligns, *colpos;
+    int added = 0;
+    BOOL prev_text = FALSE;	/* the previous line has text */
+    BOOL prev_wrapped = FALSE;	/* ...and it was wrapped */
+
+    cells = typecallocn(StblCell, (size_t) (ncols + 1));
+    cols = typecallocn(int, (size_t) (4 * (ncols + 1)));
+    if (cells == NULL || cols == NULL) {
+	FREE(cells);
+	FREE(cols);
+	return 0;
+    }
+    spans = cols + ncols + 1;
+    aligns = spans + ncols + 1;
+    colpos = aligns + ncols + 1;
+    if (colstart != NULL) {
+	int ic;
+
+	for (ic = 0; ic <= ncols; ++ic)
+	    colpos[ic] = Stbl_getColumnPos(me->stbl, ic);
+    }
+
+    for (; line && lineno <= last_lineno && line != me->last_line; lineno++) {
+	HTLine *next = line->next;
+	HTLine *prev = line->prev;
+	BOOL has_text = (BOOL) !HText_TrueEmptyLine(line, me, FALSE);
+	int nlines = 1;
+	int ncells = 0;
+	int ic;
+
+	while (a && a->line_num < lineno) {
+	    a->line_num += added;
+	    a = a->next;
+	}
+	if (colstart != NULL) {
+	    ncells = Stbl_getRowCells(me->stbl, lineno, cols, spans, aligns);
+	    for (ic = 0; ic < ncells; ++ic) {
+		cells[ic].col = cols[ic];
+		cells[ic].span = spans[ic];
+	    }
+	    if (ncells > 0) {
+		stbl_find_fields(line, lineno, a);
+		stbl_find_cells(me, line, cells, ncells, colpos);
+		for (ic = 0; ic < ncells; ++ic) {
+		    cells[ic].alignment = aligns[ic];
+		    cells[ic].width = (colstart[cols[ic] + spans[ic]]
+				       - colstart[cols[ic]]
+				       - STBL_GUTTER);
+		    cells[ic].col = colstart[cols[ic]];
+		}
+	    }
+	} else if (WRAP_COLS(me) - (int) line->offset >= STBL_MIN_WRAP) {
+	    int width = WRAP_COLS(me) - (int) line->offset;
+	    int indent, longest;
+
+	    stbl_find_fields(line, lineno, a);
+	    if (stbl_data_width(me, line, line->data, line->data + line->size,
+				&longest) > width) {
+		colpos[0] = 0;
+		cells[0].col = 0;
+		cells[0].span = 1;
+		ncells = 1;
+		stbl_find_cells(me, line, cells, ncells, colpos);
+		/* keep the line's indentation, if there is room for it */
+		indent = stbl_data_width(me, line, line->data, cells[0].text,
+					 &longest);
+		if (indent > width - STBL_MIN_WRAP)
+		    indent = 0;
+		cells[0].alignment = HT_LEFT;
+		cells[0].col = indent;
+		cells[0].width = width - indent;
+	    }
+	}
+	if (ncells > 0 && (int) line->size <= MAX_LINE) {
+	    TextAnchor *on_line = a;
+
+	    nlines = stbl_wrap_line(me, line, lineno + added,
+				    cells, ncells, &a, lineno);
+	    if (has_text && prev_text && (prev_wrapped || nlines > 1)) {
+		stbl_insert_blank(prev);
+		for (; on_line != a; on_line = on_line->next)
+		    on_line->line_num++;
+		added++;
+	    }
+	    added += nlines - 1;
+	} else {
+	    if (has_text && prev_text && prev_wrapped) {
+		stbl_insert_blank(prev);
+		added++;
+	    }
+	    while (a && a->line_num == lineno) {
+		a->line_num += added;
+		a = a->next;
+	    }
+	}
+	prev_text = has_text;
+	prev_wrapped = (BOOL) (nlines > 1);
+	line = next;
+    }
+    for (; a; a = a->next)
+	a->line_num += added;
+    me->Lines += added;
+
+    free(cells);
+    free(cols);
+    return added;
+}
+
+/*
+ * Wrap the lines of a table which could not be formatted, e.g., because it
+ * was cancelled.
+ */
+static int HText_wrapUnfinishedStbl(HText *me)
+{
+    HTLine *line;
+    int lineno = Stbl_getStartLine(me->stbl);
+    int i;
+
+    if (lineno < 0 || lineno > me->Lines)
+	return 0;
+    if ((int) me->last_line->offset
+	+ HText_TrueLineSize(me->last_line, me, FALSE) > WRAP_COLS(me))
+	new_line(me);
+    for (line = FirstHTLine(me), i = 0; i < lineno; line = line->next, i++) {
+	if (!line)
+	    return 0;
+    }
+    return HText_wrapStblLines(me, line, lineno, me->Lines,
+			       me->last_anchor_before_stbl, 1, NULL);
+}
+
+/*
+ * Choose the widths of the columns of a table which is too wide, and set
+ * 'colstart' to where each column begins.  Returns the resulting width, or -1
+ * if the table's rows cannot be wrapped into columns.
+ */
+static int stbl_plan_columns(HText *me, HTLine *first_line, int first_lineno,
+			     int last_lineno,
+			     TextAnchor *before,
+			     int ncols,
+			     int avail,
+			     int *colstart)
+{
+    TextAnchor *a;
+    BOOL fields = FALSE;
+    StblCell *cells;
+    int *cols, *spans, *aligns, *colpos, *maxw, *minw;
+    int pass, ic, lineno;
+    int summax = 0, summin = 0;
+    int room = avail - STBL_GUTTER * (ncols - 1);
+    int result = -1;
+    HTLine *line;
+
+    if (room < ncols)
+	return -1;
+    cells = typecallocn(StblCell, (size_t) (ncols + 1));
+    cols = typecallocn(int, (size_t) (6 * (ncols + 1)));
+    if (cells == NULL || cols == NULL) {
+	FREE(cells);
+	FREE(cols);
+	return -1;
+    }
+    spans = cols + ncols + 1;
+    aligns = spans + ncols + 1;
+    colpos = aligns + ncols + 1;
+    maxw = colpos + ncols + 1;
+    minw = maxw + ncols + 1;
+    for (ic = 0; ic <= ncols; ++ic)
+	colpos[ic] = Stbl_getColumnPos(me->stbl, ic);
+
+    /*
+     * Measure the cells which span one column, then make room for those
+     * which span several.
+     */
+    for (pass = 0; pass < 2; ++pass) {
+	a = (before != NULL) ? before : me->first_anchor;
+	for (line = first_line, lineno = first_lineno;
+	     line && lineno <= last_lineno && line != me->last_line;
+	     line = line->next, lineno++) {
+	    int ncells = Stbl_getRowCells(me->stbl, lineno, cols, spans, aligns);
+
+	    while (a && a->line_num < lineno)
+		a = a->next;
+
+	    if (ncells < 0) {
+		if (HText_TrueEmptyLine(line, me, FALSE))
+		    continue;
+		CTRACE((tfp, "stbl_plan_columns: line %d is not a row\n", lineno));
+		goto done;
+	    }
+	    for (ic = 0; ic < ncells; ++ic) {
+		cells[ic].col = cols[ic];
+		cells[ic].span = spans[ic];
+	    }
+	    if (stbl_find_fields(line, lineno, a))
+		fields = TRUE;
+	    stbl_find_cells(me, line, cells, ncells, colpos);
+	    for (ic = 0; ic < ncells; ++ic) {
+		int longest;
+		int width = stbl_data_width(me, line,
+					    cells[ic].text, cells[ic].end,
+					    &longest);
+		int col = cols[ic];
+		int span = spans[ic];
+
+		if (pass == 0 && span == 1) {
+		    maxw[col] = HTMAX(maxw[col], width);
+		    minw[col] = HTMAX(minw[col], longest);
+		} else if (pass == 1 && span > 1) {
+		    int have_max = STBL_GUTTER * (span - 1);
+		    int have_min = have_max;
+		    int j;
+
+		    for (j = col; j < col + span; ++j) {
+			have_max += maxw[j];
+			have_min += minw[j];
+		    }
+		    for (j = 0; j < span; ++j) {
+			if (width > have_max)
+			    maxw[col + j] += ((width - have_max) / span
+					      + (j < (width - have_max) % span));
+			if (longest > have_min)
+			    minw[col + j] += ((longest - have_min) / span
+					      + (j < (longest - have_min) % span));
+		    }
+		}
+	    }
+	}
+    }
+
+    for (ic = 0; ic < ncols; ++ic) {
+	summax += maxw[ic];
+	summin += minw[ic];
+    }
+    if (summax <= room) {
+	for (ic = 0; ic < ncols; ++ic)
+	    colpos[ic] = maxw[ic];
+    } else if (summin <= room) {
+	/* share what is left over after the longest words */
+	int extra = room - summin;
+	int used = 0;
+
+	for (ic = 0; ic < ncols; ++ic) {
+	    colpos[ic] = minw[ic] + (int) (((long) (maxw[ic] - minw[ic])
+					    * extra) / (summax - summin));
+	    used += colpos[ic];
+	}
+	for (ic = 0; used < room && ic < ncols; ++ic) {
+	    if (colpos[ic] < maxw[ic]) {
+		colpos[ic]++;
+		used++;
+	    }
+	}
+    } else {
+	/* words or form fields would overlap the next column */
+	CTRACE((tfp, "stbl_plan_columns: %s do not fit\n",
+		fields ? "form fields" : "words"));
+	goto done;
+    }
+    colstart[0] = 0;
+    for (ic = 0; ic < ncols; ++ic)
+	colstart[ic + 1] = colstart[ic] + colpos[ic] + STBL_GUTTER;
+    result = colstart[ncols] - STBL_GUTTER;
+    CTRACE((tfp, "stbl_plan_columns: %d columns, width %d of %d (min %d, max %d)\n",
+	    ncols, result, avail, summin, summax));
+
+  done:
+    free(cells);
+    free(cols);
+    return result;
+}
+
 /*
  * HText_insertBlanksInStblLines fixes up table lines when simple table
  * processing is closed, by calling insert_blanks_in_line for lines
@@ -4600,10 +5519,14 @@ static int HText_insertBlanksInStblLines(HText *me, int ncols)
 {
     HTLine *line;
     HTLine *mod_line, *first_line = NULL;
+    HTLine *start_line;
+    TextAnchor *before = me->last_anchor_before_stbl;
     int *oldpos;
     int *newpos;
+    int *colstart = NULL;
     int ninserts, lineno;
-    int last_lineno, first_lineno_pass2;
+    int last_lineno, first_lineno_pass2, start_lineno;
+    BOOL aligned = TRUE;
 
 #ifdef EXP_NESTED_TABLES
     int last_nonempty = -1;
@@ -4632,6 +5555,8 @@ static int HText_insertBlanksInStblLines(HText *me, int ncols)
 	    return -1;
 	}
     }
+    start_line = line;
+    start_lineno = lineno;
     first_lineno_pass2 = last_lineno = me->Lines;
     for (; line && lineno <= last_lineno; line = line->next, lineno++) {
 	ninserts = Stbl_getFixupPositions(me->stbl, lineno, oldpos, newpos);
@@ -4693,6 +5618,8 @@ static int HText_insertBlanksInStblLines(HText *me, int ncols)
 	    lines_changed++;
 	    if (line == first_line)
 		first_line = mod_line;
+	    if (line == start_line)
+		start_line = mod_line;
 	    freeHTLine(me, line);
 	    line = mod_line;
 #ifdef DISP_PARTIAL
@@ -4708,7 +5635,10 @@ static int HText_insertBlanksInStblLines(HText *me, int ncols)
 		}
 	    }
 #endif
-	} {
+	} else if (line->size) {
+	    aligned = FALSE;	/* line was too long to fix */
+	}
+	{
 	    int width = HText_TrueLineSize(line, me, FALSE);
 
 	    if (width > max_width)
@@ -4754,6 +5684,23 @@ static int HText_insertBlanksInStblLines(HText *me, int ncols)
     if (alignment == HT_ALIGN_NONE)
 	alignment = style->alignment;
     indent = style->leftIndent;
+    if (Stbl_wrapCells()
+	&& (max_width > WRAP_COLS(me) - indent
+	    || (first_line != NULL
+		&& stbl_widest_line(me, first_line, first_lineno_pass2,
+				    last_lineno) > WRAP_COLS(me) - indent))) {
+	int width = -1;
+
+	if (aligned && first_line != NULL
+	    && (colstart = typecallocn(int, (size_t) ncols + 1)) != NULL) {
+	    width = stbl_plan_columns(me, first_line, first_lineno_pass2,
+				      last_lineno, before, ncols,
+				      WRAP_COLS(me) - indent, colstart);
+	    if (width < 0)
+		FREE(colstart);
+	}
+	max_width = (width >= 0) ? width : (WRAP_COLS(me) - indent);
+    }
     /* Calculate spare character positions */
     spare = WRAP_COLS(me) -
 	(int) style->rightIndent - indent - max_width;
@@ -4828,6 +5775,16 @@ static int HText_insertBlanksInStblLines(HText *me, int ncols)
     }
 #endif
     CTRACE((tfp, " %d:done\n", lineno));
+    if (colstart != NULL) {
+	lines_changed += HText_wrapStblLines(me, first_line, first_lineno_pass2,
+					     last_lineno, before,
+					     ncols, colstart);
+	free(colstart);
+    } else if (Stbl_wrapCells()) {
+	lines_changed += HText_wrapStblLines(me, start_line, start_lineno,
+					     last_lineno, before,
+					     1, NULL);
+    }
     free(oldpos);
     return lines_changed;
 }
@@ -4845,6 +5802,8 @@ void HText_cancelStbl(HText *me)
 	return;
     }
     CTRACE((tfp, "cancelStbl: ok, will do.\n"));
+    if (Stbl_wrapCells())
+	HText_wrapUnfinishedStbl(me);
 #ifdef EXP_NESTED_TABLES
     if (nested_tables) {
 	STable_info *stbl = me->stbl;
@@ -4883,6 +5842,7 @@ void HText_startStblTABLE(HText *me, int alignment)
 	}
 
 	me->stbl = Stbl_startTABLE(alignment);
+	me->uses_width = TRUE;
 	if (me->stbl) {
 	    CTRACE((tfp, "startStblTABLE: started.\n"));
 #ifdef EXP_NESTED_TABLES
@@ -4944,6 +5904,8 @@ BOOLEAN HText_endStblTABLE(HText *me)
 	 */
 	NumOfLines_partial -= lines_changed;	/* fake */
 #endif /* DISP_PARTIAL */
+    } else if (Stbl_wrapCells()) {
+	lines_changed = HText_wrapUnfinishedStbl(me);
     }
 #ifdef EXP_NESTED_TABLES
     if (nested_tables) {
@@ -5076,38 +6038,102 @@ void HText_startStblRowGroup(HText *me, int alignment)
     }
 }
 
+#define UNIQUE_HASH_SIZE 1021	/* Arbitrary prime, the initial size */
+
+/*
+ * Return the address which -unique-urls compares for the given anchor, or
+ * null if it has none.
+ */
+static const char *unique_address(TextAnchor *a)
+{
+    HTAnchor *dest;
+
+    if (a->anchor != 0
+	&& (dest = a->anchor->dest) != 0
+	&& dest->parent != 0)
+	return dest->parent->address;
+    return 0;
+}
+
+static unsigned unique_hash(const char *address, const char *tag)
+{
+    unsigned hash = 0;
+
+    while (*address != '\0')
+	hash = (hash * 31) + UCH(*address++);
+    while (*tag != '\0')
+	hash = (hash * 31) + UCH(*tag++);
+    return hash;
+}
+
+/*
+ * Make the hash table twice as large (plus one, to keep it odd) when it has
+ * twice as many anchors as chains, so the chains stay short on large pages.
+ */
+static void grow_unique_hash(HText *text)
+{
+    TextAnchor **table;
+    unsigned size = (text->unique_size * 2) + 1;
+    unsigned n;
+
+    if ((table = typecallocn(TextAnchor *, size)) == 0)
+	outofmem(__FILE__, "grow_unique_hash");
+    for (n = 0; n < text->unique_size; ++n) {
+	TextAnchor *a = text->unique_hash[n];
+
+	while (a != 0) {
+	    TextAnchor *next = a->next_unique;
+	    unsigned hash = (unique_hash(unique_address(a),
+					 NonNull(a->anchor->tag)) % size);
+
+	    a->next_unique = table[hash];
+	    table[hash] = a;
+	    a = next;
+	}
+    }
+    FREE(text->unique_hash);
+    text->unique_hash = table;
+    text->unique_size = size;
+}
+
+/*
+ * For -unique-urls, anchors which are given a new number are remembered in a
+ * hash table keyed by their destination address and tag, so that later links
+ * to the same place can reuse the number without searching the anchor list.
+ */
 static void compute_show_number(TextAnchor *a)
 {
-    HTAnchor *cur, *tst;
+    const char *address;
+    const char *tag;
     TextAnchor *b;
-    int match;
+    unsigned hash;
 
     a->show_number = a->number;
     if (unique_urls
 	&& HTMainText != 0
-	&& HTMainText->first_anchor != 0
-	&& a->anchor != 0
-	&& (cur = a->anchor->dest) != 0
-	&& cur->parent != 0
-	&& cur->parent->address != 0) {
-
-	match = 0;
-	for (b = HTMainText->first_anchor; b != a; b = b->next) {
-	    if (b->anchor != 0
-		&& (tst = b->anchor->dest) != 0
-		&& tst->parent != 0
-		&& tst->parent->address != 0
-		&& !strcmp(cur->parent->address,
-			   tst->parent->address)
-		&& !strcmp(NonNull(a->anchor->tag), NonNull(b->anchor->tag))) {
-		match = b->show_number;
-		break;
+	&& (address = unique_address(a)) != 0) {
+
+	tag = NonNull(a->anchor->tag);
+	if (HTMainText->unique_hash == 0) {
+	    HTMainText->unique_hash = typecallocn(TextAnchor *, UNIQUE_HASH_SIZE);
+	    if (HTMainText->unique_hash == 0)
+		outofmem(__FILE__, "compute_show_number");
+	    HTMainText->unique_size = UNIQUE_HASH_SIZE;
+	    HTMainText->unique_count = 0;
+	}
+	hash = unique_hash(address, tag) % HTMainText->unique_size;
+	for (b = HTMainText->unique_hash[hash]; b != 0; b = b->next_unique) {
+	    if (!strcmp(address, unique_address(b))
+		&& !strcmp(tag, NonNull(b->anchor->tag))) {
+		a->show_number = b->show_number;
+		return;
 	    }
 	}
-	if (match)
-	    a->show_number = match;
-	else
-	    a->show_number = HTMainText->next_number++;
+	a->show_number = HTMainText->next_number++;
+	a->next_unique = HTMainText->unique_hash[hash];
+	HTMainText->unique_hash[hash] = a;
+	if (++(HTMainText->unique_count) > 2 * HTMainText->unique_size)
+	    grow_unique_hash(HTMainText);
     }
 }
 
@@ -5496,6 +6522,7 @@ static BOOL HText_endAnchor0(HText *text, int number,
 			    }
 			}
 			start->size = (unsigned short) j;
+			ForgetLineWidth(start);
 			start->data[j++] = '\0';
 			while (j < k)
 			    start->data[j++] = '\0';
@@ -5523,6 +6550,7 @@ static BOOL HText_endAnchor0(HText *text, int number,
 			    while (i < (int) prev->size)
 				prev->data[j++] = prev->data[i++];
 			    prev->size = (unsigned short) j;
+			    ForgetLineWidth(prev);
 			    prev->data[j] = '\0';
 			    while (j < i)
 				prev->data[j++] = '\0';
@@ -5543,6 +6571,7 @@ static BOOL HText_endAnchor0(HText *text, int number,
 				}
 			    }
 			    start->size = (unsigned short) j;
+			    ForgetLineWidth(start);
 			    start->data[j++] = '\0';
 			    while (j < k)
 				start->data[j++] = '\0';
@@ -5591,6 +6620,7 @@ static BOOL HText_endAnchor0(HText *text, int number,
 			    while (k < (int) prev->size)
 				prev->data[j++] = prev->data[k++];
 			    prev->size = (unsigned short) j;
+			    ForgetLineWidth(prev);
 			    prev->data[j++] = '\0';
 			    while (j < k)
 				prev->data[j++] = '\0';
@@ -5795,6 +6825,10 @@ void HText_endAppend(HText *text)
      * create the hightext strings.  -FM
      */
     HText_trimHightext(text, TRUE, -1);
+
+    text->anchors_complete = TRUE;
+    free_anchor_table(text);
+    (void) get_anchor_table(text);
 }
 
 /*
@@ -5837,6 +6871,19 @@ static void HText_trimHightext(HText *text,
     int actual_len;
     int count_line;
 
+    /*
+     * Anchors on the same line are usually in order, so we remember where
+     * the last one began, and continue counting columns from there.
+     */
+    HTLine *ckpt_line = NULL;
+    int ckpt_col = 0;		/* byte offset in ckpt_line->data */
+#ifdef WIDEC_CURSES
+    int ckpt_cells = 0;		/* ...its column */
+#else
+    int ckpt_skip = 0;		/* ...the bytes before it which do not display */
+    int ckpt_soft = 0;		/* ...and the soft newlines among those */
+#endif
+
     if (!text)
 	return;
 
@@ -6059,22 +7106,41 @@ static void HText_trimHightext(HText *text,
 	     * LYstrExtent filters out the formatting characters, so we do not
 	     * have to count them here, except for soft newlines.
 	     */
-	    anchor_ptr->line_pos = (short) LYstrExtent2(line_ptr->data, anchor_col);
+	    if (ckpt_line != line_ptr || ckpt_col > anchor_col) {
+		ckpt_line = line_ptr;
+		ckpt_col = 0;
+		ckpt_cells = 0;
+	    }
+	    ckpt_cells += LYstrExtent2(line_ptr->data + ckpt_col,
+				       anchor_col - ckpt_col);
+	    ckpt_col = anchor_col;
+	    anchor_ptr->line_pos = (short) ckpt_cells;
 	    if (line_ptr->data[0] == LY_SOFT_NEWLINE)
 		anchor_ptr->line_pos = (short) (anchor_ptr->line_pos + 1);
 	}
 #else /* 8-bit curses, etc.  */
 	if (anchor_ptr->line_pos > 0) {
-	    register int offset = 0, i = 0;
-	    int have_soft_newline_in_1st_line = 0;
-
-	    for (; i < anchor_col; i++) {
+	    register int offset, i;
+	    int have_soft_newline_in_1st_line;
+
+	    if (ckpt_line != line_ptr || ckpt_col > anchor_col) {
+		ckpt_line = line_ptr;
+		ckpt_col = 0;
+		ckpt_skip = 0;
+		ckpt_soft = 0;
+	    }
+	    offset = ckpt_skip;
+	    have_soft_newline_in_1st_line = ckpt_soft;
+	    for (i = ckpt_col; i < anchor_col; i++) {
 		if (IS_UTF_EXTRA(line_ptr->data[i]) ||
 		    IsSpecialAttrChar(line_ptr->data[i])) {
 		    offset++;
 		    have_soft_newline_in_1st_line += (line_ptr->data[i] == LY_SOFT_NEWLINE);
 		}
 	    }
+	    ckpt_col = anchor_col;
+	    ckpt_skip = offset;
+	    ckpt_soft = have_soft_newline_in_1st_line;
 	    anchor_ptr->line_pos = (short) (anchor_ptr->line_pos - offset);
 	    /*handle LY_SOFT_NEWLINEs -VH */
 	    anchor_ptr->line_pos = (short) (anchor_ptr->line_pos + have_soft_newline_in_1st_line);
@@ -6112,16 +7178,24 @@ HTChildAnchor *HText_childNextNumber(int number, void **prev)
 {
     /* Sorry, TextAnchor is not declared outside this file, use a cast. */
     TextAnchor *a = (TextAnchor *) *prev;
+    AnchorTable *table;
 
     if (!HTMainText || number <= 0)
 	return (HTChildAnchor *) 0;	/* Fail */
-    if (number == 1 || !a)
-	a = HTMainText->first_anchor;
 
-    /* a strange thing:  positive a->number's are sorted,
-     * and between them several a->number's may be 0 -- skip them
-     */
-    for (; a && a->number != number; a = a->next) ;
+    if ((table = get_anchor_table(HTMainText)) != 0) {
+	a = ((number <= table->max_number)
+	     ? table->by_number[number]
+	     : 0);
+    } else {
+	if (number == 1 || !a)
+	    a = HTMainText->first_anchor;
+
+	/* a strange thing:  positive a->number's are sorted,
+	 * and between them several a->number's may be 0 -- skip them
+	 */
+	for (; a && a->number != number; a = a->next) ;
+    }
 
     if (!a)
 	return (HTChildAnchor *) 0;	/* Fail */
@@ -6881,6 +7955,93 @@ int HText_getNumOfBytes(void)
     return result;
 }
 
+static long FormInfoMemory(FormInfo * f)
+{
+    long result = (StrMemory(f->name)
+		   + StrMemory(f->value)
+		   + StrMemory(f->orig_value)
+		   + StrMemory(f->submit_action)
+		   + StrMemory(f->submit_enctype)
+		   + StrMemory(f->submit_title)
+		   + StrMemory(f->cp_submit_value)
+		   + StrMemory(f->orig_submit_value)
+		   + StrMemory(f->accept_cs));
+    OptionType *op;
+
+    for (op = f->select_list; op != 0; op = op->next) {
+	result += StrMemory(op->name) + StrMemory(op->cp_submit_value);
+    }
+    if (f->select_names != 0)
+	result += (f->select_count + 1) * (long) sizeof(char *);
+    return result;
+}
+
+/*
+ * HText_memoryUsed estimates the memory used by a document:  its pools, which
+ * hold the lines, anchors and form fields, and what those point to which was
+ * allocated separately.  If pools is nonnull, it is set to the number of
+ * pools.
+ */
+long HText_memoryUsed(HText *text, long *pools)
+{
+    long result = 0;
+    long count = 0;
+
+    if (text != 0) {
+	HTPool *pool;
+	TextAnchor *a;
+
+	result = (long) sizeof(HText);
+	for (pool = text->pool; pool != 0; pool = pool->prev) {
+	    ++count;
+	}
+	result += count * (long) sizeof(HTPool);
+
+	for (a = text->first_anchor; a != 0; a = a->next) {
+	    if (a->lites.hl_info != 0)
+		result += a->lites.hl_len * (long) sizeof(HiliteInfo);
+	    if (a->input_field != 0)
+		result += FormInfoMemory(a->input_field);
+	}
+	result += HTList_count(text->forms) * (long) (sizeof(PerFormInfo)
+						      + sizeof(HTList));
+	result += HTList_count(text->hidden_links) * (long) sizeof(HTList);
+	result += HTList_count(text->tabs) * (long) (sizeof(HTTabID)
+						     + sizeof(HTList));
+	if (text->unique_hash != 0)
+	    result += text->unique_size * (long) sizeof(TextAnchor *);
+	if (text->anchor_table != 0) {
+	    AnchorTable *table = text->anchor_table;
+
+	    result += (long) sizeof(AnchorTable);
+	    result += (table->count + 1) * (long) (sizeof(TextAnchor *)
+						   + sizeof(AnchorOffset));
+	    result += (table->max_number + 1) * (long) sizeof(TextAnchor *);
+	}
+    }
+    if (pools != 0)
+	*pools = count;
+    return result;
+}
+
+/*
+ * HText_cacheMemory sums the memory used by the documents cached in memory
+ * (see HTCacheSize), setting documents to their number.
+ */
+long HText_cacheMemory(long *documents)
+{
+    HTList *cur = loaded_texts;
+    HText *text;
+    long result = 0;
+
+    *documents = 0;
+    while ((text = (HText *) HTList_nextObject(cur)) != NULL) {
+	result += HText_memoryUsed(text, (long *) 0);
+	++(*documents);
+    }
+    return result;
+}
+
 /*
  * HText_getTitle returns the title of the
  * current document.
@@ -7147,6 +8308,34 @@ int HText_closestAnchor(HText *text, int offset)
     int newdiff;
     TextAnchor *Anchor_ptr = NULL;
     TextAnchor *closest = NULL;
+    AnchorTable *table;
+
+    if ((table = get_anchor_table(text)) != 0) {
+	int above = offset_in_table(table, offset);
+	int below = -1;
+
+	/*
+	 * Like the loop below, prefer an exact match, then the nearest offset,
+	 * and of anchors which are equally near, the first in the list.
+	 */
+	if (above > 0)
+	    below = offset_in_table(table, table->by_offset[above - 1].offset);
+	if (above >= table->count) {
+	    above = below;
+	} else if (below >= 0
+		   && table->by_offset[above].offset != offset) {
+	    int diff_above = table->by_offset[above].offset - offset;
+	    int diff_below = offset - table->by_offset[below].offset;
+
+	    if (diff_below < diff_above
+		|| (diff_below == diff_above
+		    && table->by_offset[below].seq < table->by_offset[above].seq))
+		above = below;
+	}
+	if (above >= 0)
+	    result = table->list[table->by_offset[above].seq]->number;
+	return result;
+    }
 
     for (Anchor_ptr = text->first_anchor;
 	 Anchor_ptr != NULL;
@@ -7177,6 +8366,15 @@ int HText_locateAnchor(HText *text, int anchor_number)
 {
     int result = -1;
     TextAnchor *Anchor_ptr = NULL;
+    AnchorTable *table;
+
+    if (anchor_number > 0
+	&& (table = get_anchor_table(text)) != 0) {
+	if (anchor_number <= table->max_number
+	    && (Anchor_ptr = table->by_number[anchor_number]) != 0)
+	    result = Anchor_ptr->sgml_offset;
+	return result;
+    }
 
     for (Anchor_ptr = text->first_anchor;
 	 Anchor_ptr != NULL;
@@ -8502,8 +9700,23 @@ static BOOL anchor_has_target(TextAnchor *a, char *target)
 static TextAnchor *line_num_to_anchor(int line_num)
 {
     TextAnchor *a;
+    AnchorTable *table;
 
-    if (HTMainText != 0) {
+    if ((table = get_anchor_table(HTMainText)) != 0
+	&& table->lines_sorted) {
+	int lo = 0;
+	int hi = table->count;
+
+	while (lo < hi) {
+	    int mid = (lo + hi) / 2;
+
+	    if (table->list[mid]->line_num < line_num)
+		lo = mid + 1;
+	    else
+		hi = mid;
+	}
+	a = table->list[lo];
+    } else if (HTMainText != 0) {
 	a = HTMainText->first_anchor;
 	while (a != 0 && a->line_num < line_num) {
 	    a = a->next;
@@ -8533,7 +9746,7 @@ static TextAnchor *get_prev_anchor(TextAnchor *a)
 {
     TextAnchor *p, *q;
 
-    if (a->prev == 0) {
+    if (a->prev == 0 && get_anchor_table(HTMainText) == 0) {
 	if ((p = HTMainText->first_anchor) != 0) {
 	    while ((q = p->next) != 0) {
 		q->prev = p;
@@ -8869,7 +10082,7 @@ BOOLEAN HTreparse_document(void)
 	     * would be an unnecessary "loop"). - kw
 	     */
 	    HTAnchor_setProtocol(HTMainAnchor, &HTFile);
-	    ret = HTParseFile(format, HTOutputFormat, HTMainAnchor, fp, NULL);
+	    ret = HTParseMappedFile(format, HTOutputFormat, HTMainAnchor, fp, NULL);
 	    LYCloseInput(fp);
 	    if (ret == HT_PARTIAL_CONTENT) {
 		HTInfoMsg(gettext("Loading incomplete."));
@@ -8944,6 +10157,21 @@ BOOLEAN HTcan_reparse_document(void)
     return result;
 }
 
+/*
+ * Returns true if the text might be laid out differently for the current
+ * screen width than for the one it was laid out for.  This does not reflow
+ * the lines; it only spares the reparse for documents whose lines are all
+ * short enough for both widths, e.g., source views and preformatted text.
+ * Wrapped paragraphs come near the margin, and are reparsed as before.
+ */
+static BOOL layout_uses_width(HText *text)
+{
+    int narrowest = HTMIN(text->disp_cols, DISPLAY_COLS);
+
+    return (BOOL) (text->uses_width ||
+		   text->widest + EXTENT_SLACK > narrowest);
+}
+
 static void trace_setting_change(const char *name,
 				 int prev_setting,
 				 int new_setting)
@@ -8987,6 +10215,9 @@ BOOLEAN HTdocument_settings_changed(void)
 	trace_setting_change("OLD_DTD", HTMainText->old_dtd, Old_DTD);
 	trace_setting_change("KEYPAD_MODE",
 			     HTMainText->keypad_mode, keypad_mode);
+	if (!HText_usesImageSettings(HTMainText))
+	    CTRACE((tfp,
+		    "HTdocument_settings_changed: no images, ignoring image settings\n"));
 	if (HTMainText->disp_lines != LYlines || HTMainText->disp_cols != DISPLAY_COLS)
 	    CTRACE((tfp,
 		    "HTdocument_settings_changed: Screen size has changed (was %dx%d, now %dx%d)\n",
@@ -8994,11 +10225,16 @@ BOOLEAN HTdocument_settings_changed(void)
 		    HTMainText->disp_lines,
 		    DISPLAY_COLS,
 		    LYlines));
+	if (HTMainText->disp_cols != DISPLAY_COLS &&
+	    !layout_uses_width(HTMainText))
+	    CTRACE((tfp,
+		    "HTdocument_settings_changed: layout does not depend on the width\n"));
     }
 
-    return (BOOLEAN) (HTMainText->clickable_images != clickable_images ||
-		      HTMainText->pseudo_inline_alts != pseudo_inline_alts ||
-		      HTMainText->verbose_img != verbose_img ||
+    return (BOOLEAN) (((HTMainText->clickable_images != clickable_images ||
+		       HTMainText->pseudo_inline_alts != pseudo_inline_alts ||
+		       HTMainText->verbose_img != verbose_img) &&
+		       HText_usesImageSettings(HTMainText)) ||
 		      HTMainText->raw_mode != LYUseDefaultRawMode ||
 		      HTMainText->historical_comments != historical_comments ||
 		      (HTMainText->minimal_comments != minimal_comments &&
@@ -9006,7 +10242,8 @@ BOOLEAN HTdocument_settings_changed(void)
 		      HTMainText->soft_dquotes != soft_dquotes ||
 		      HTMainText->old_dtd != Old_DTD ||
 		      HTMainText->keypad_mode != keypad_mode ||
-		      HTMainText->disp_cols != DISPLAY_COLS);
+		      (HTMainText->disp_cols != DISPLAY_COLS &&
+		       layout_uses_width(HTMainText)));
 }
 #endif
 
@@ -9174,12 +10411,20 @@ static int HText_TrueLineSize(HTLine *line, HText *text, int IgnoreSpaces)
 	    }
 	}
     } else {
-	for (i = 0; i < line->size; i++) {
+	/*
+	 * Count only the characters added since the last call.
+	 */
+	if (line->width_size > line->size)
+	    ForgetLineWidth(line);
+	true_size = line->width;
+	for (i = line->width_size; i < line->size; i++) {
 	    if (!IsSpecialAttrChar(line->data[i]) &&
 		IS_UTF8_EXTRA(line->data[i])) {
 		true_size++;
 	    }
 	}
+	line->width_size = line->size;
+	line->width = (unsigned short) true_size;
     }
     return true_size;
 }
@@ -9664,8 +10909,7 @@ void HText_beginSelect(char *name,
 int HText_getOptionNum(HText *text)
 {
     TextAnchor *a;
-    OptionType *op;
-    int n = 1;			/* start count at 1 */
+    int n;
 
     if (!(text && text->last_anchor))
 	return (0);
@@ -9675,8 +10919,7 @@ int HText_getOptionNum(HText *text)
 	  a->input_field->type == F_OPTION_LIST_TYPE))
 	return (0);
 
-    for (op = a->input_field->select_list; op; op = op->next)
-	n++;
+    n = a->input_field->select_count + 1;	/* start count at 1 */
     CTRACE((tfp, "HText_getOptionNum: Got number '%d'.\n", n));
     return (n);
 }
@@ -9823,7 +11066,7 @@ char *HText_setLastOptionValue(HText *text, char *value,
 	/*
 	 * Create a linked list of option values.
 	 */
-	OptionType *op_ptr = text->last_anchor->input_field->select_list;
+	FormInfo *field = text->last_anchor->input_field;
 	OptionType *new_ptr = NULL;
 	BOOLEAN first_option = FALSE;
 
@@ -9832,36 +11075,35 @@ char *HText_setLastOptionValue(HText *text, char *value,
 	 */
 	LYReduceBlanks(value);
 
-	if (!op_ptr) {
+	if (!field->select_list) {
 	    /*
 	     * No option items yet.
 	     */
-	    if (text->last_anchor->input_field->type != F_OPTION_LIST_TYPE) {
+	    if (field->type != F_OPTION_LIST_TYPE) {
 		CTRACE((tfp,
 			"HText_setLastOptionValue: last input_field not F_OPTION_LIST_TYPE (%d)\n",
 			F_OPTION_LIST_TYPE));
 		CTRACE((tfp, "                          but %d, ignoring!\n",
-			text->last_anchor->input_field->type));
+			field->type));
 		return NULL;
 	    }
 
-	    new_ptr = typecalloc(OptionType);
-	    if (new_ptr == NULL)
-		outofmem(__FILE__, "HText_setLastOptionValue");
-
-	    text->last_anchor->input_field->select_list = new_ptr;
+	    new_ptr = (OptionType *) ALLOC_IN_POOL(&text->pool, sizeof(OptionType));
+	    field->select_list = new_ptr;
 	    first_option = TRUE;
 	} else {
-	    while (op_ptr->next) {
-		number++;
-		op_ptr = op_ptr->next;
-	    }
-	    number++;		/* add one more */
+	    /*
+	     * Append to the list, remembering its end rather than walking it,
+	     * since a SELECT may have thousands of options.
+	     */
+	    number = field->select_count;
 
-	    op_ptr->next = new_ptr = typecalloc(OptionType);
-	    if (new_ptr == NULL)
-		outofmem(__FILE__, "HText_setLastOptionValue");
+	    new_ptr = (OptionType *) ALLOC_IN_POOL(&text->pool, sizeof(OptionType));
+	    field->select_last->next = new_ptr;
 	}
+	field->select_last = new_ptr;
+	field->select_count++;
+	FREE(field->select_names);
 
 	assert(new_ptr != NULL);
 	new_ptr->name = NULL;
@@ -10092,6 +11334,9 @@ int HText_beginInput(HText *text,
     a->input_field = f;
 
     f->select_list = 0;
+    f->select_last = 0;
+    f->select_count = 0;
+    f->select_names = 0;
     f->number = HTFormNumber;
     f->disabled = HTFormDisabled || I->disabled;
     f->readonly = I->readonly;
@@ -10402,6 +11647,7 @@ int HText_beginInput(HText *text,
     /*
      * Restrict SIZE to maximum allowable size.
      */
+    text->uses_width = TRUE;
     MaximumSize = WRAP_COLS(text) + 1 - adjust_marker;
     switch (f->type) {
 
@@ -12120,6 +13366,48 @@ BOOL HText_hasToolbar(HText *text)
     return (BOOL) ((text && text->toolbar) ? TRUE : FALSE);
 }
 
+/*
+ * Remember the first LINK REL="Next" of the text, the page which the user
+ * is likely to read next.
+ */
+void HText_setNextLink(HText *text, const char *address)
+{
+    if (text && !text->next_link)
+	StrAllocCopy(text->next_link, address);
+    return;
+}
+
+char *HText_getNextLink(void)
+{
+    return (HTMainText ? HTMainText->next_link : 0);
+}
+
+void HText_setUsesWidth(HText *text)
+{
+    if (text)
+	text->uses_width = TRUE;
+    return;
+}
+
+void HText_setHasImages(HText *text)
+{
+    if (text)
+	text->has_images = TRUE;
+    return;
+}
+
+/*
+ * Returns true if the image settings (clickable_images, pseudo_inline_alts
+ * and verbose_img) may change how the text is rendered, i.e., unless it was
+ * parsed completely without finding any images, objects and the like.
+ */
+BOOL HText_usesImageSettings(HText *text)
+{
+    return (BOOL) ((text == 0 ||
+		    !text->anchors_complete ||
+		    text->has_images) ? TRUE : FALSE);
+}
+
 void HText_setNoCache(HText *text)
 {
     if (text)
@@ -12606,6 +13894,7 @@ static int increment_tagged_htline(HTLine *ht, TextAnchor *a, int *lx_val,
 			s = StrNCpy(s, lx, pre_n) + pre_n;
 			lx += pre_n;
 			strcpy(ht->next->data, lx);
+			ForgetLineWidth(ht->next);
 
 			*lx_val = new_n - n;
 		    }
@@ -12642,6 +13931,7 @@ static int increment_tagged_htline(HTLine *ht, TextAnchor *a, int *lx_val,
 	ht->next->prev = ht;	/* Could be same node of course */
     }
     strcpy(ht->data, buf);
+    ForgetLineWidth(ht);
 
     return ((int) strlen(buf) - n + fixup);
 }
@@ -12700,6 +13990,8 @@ static void insert_new_textarea_anchor(TextAnchor **curr_anchor, HTLine **exit_h
     assert(f != NULL);
     assert(l != NULL);
 
+    free_anchor_table(HTMainText);
+
     /*  Init all the fields in the new TextAnchor.                 */
     /*  [anything "special" needed based on ->show_anchor value ?] */
     a->next = anchor->next;
@@ -12812,6 +14104,7 @@ static void update_subsequent_anchors(int newlines,
      * "hidden" anchors, if such things exist).  Seems like the "right
      * thing" to do.  I think.]
      */
+    free_anchor_table(HTMainText);
     anchor = start_anchor->next;	/* begin updating with the NEXT anchor */
     while (anchor) {
 	if (fields_are_numbered() &&
@@ -12889,6 +14182,7 @@ static void update_subsequent_anchors(int newlines,
 						   &start_tag, newlines,
 						   NOCHOP);
 		htline->size = (unsigned short) (htline->size + line_adj);
+		ForgetLineWidth(htline);
 		tag_adj += line_adj;
 
 	    } else {
@@ -13620,6 +14914,8 @@ int HText_InsertFile(LinkInfo * form_link)
     assert(f != NULL);
     assert(l != NULL);
 
+    free_anchor_table(HTMainText);
+
     /*  Init all the fields in the new TextAnchor.                 */
     /*  [anything "special" needed based on ->show_anchor value ?] */
     /* *INDENT-EQLS* */
@@ -13850,6 +15146,16 @@ static void redraw_part_of_line(HTLine *line, const char *str,
     end_of_data = data + len;
     i++;
 
+#if defined(USE_COLOR_STYLE)
+    /*
+     * The column of a style change does not depend on where we are drawing,
+     * so compute it only when we move to the next style.
+     */
+    scols = ((line->numstyles > 0)
+	     ? StyleToCols(text, line, current_style)
+	     : 0);
+#endif
+
     /* this assumes that the part of line to be drawn fits in the screen */
     while (data < end_of_data) {
 	buffer[0] = *data;
@@ -13859,7 +15165,6 @@ static void redraw_part_of_line(HTLine *line, const char *str,
 #define CStyle line->styles[current_style]
 
 	tcols = GetColumn();
-	scols = StyleToCols(text, line, current_style);
 
 	while (current_style < line->numstyles &&
 	       tcols >= scols) {
@@ -175,6 +175,8 @@ US-ASCII control characters <32 which are not defined in Unicode standard
     extern int HText_getTabIDColumn(HText *text, const char *name);
     extern int HText_getTopOfScreen(void);
     extern int do_www_search(DocInfo *doc);
+    extern long HText_cacheMemory(long *documents);
+    extern long HText_memoryUsed(HText *text, long *pools);
     extern void HText_NegateLineOne(HText *text);
     extern void HText_RemovePreviousLine(HText *text);
     extern void HText_setNodeAnchorBookmark(const char *bookmark);
@@ -246,7 +248,12 @@ US-ASCII control characters <32 which are not defined in Unicode standard
     extern char *stub_HTAnchor_address(HTAnchor * me);
 
     extern void HText_setToolbar(HText *text);
+    extern void HText_setHasImages(HText *text);
+    extern void HText_setUsesWidth(HText *text);
+    extern BOOL HText_usesImageSettings(HText *text);
     extern BOOL HText_hasToolbar(HText *text);
+    extern void HText_setNextLink(HText *text, const char *address);
+    extern char *HText_getNextLink(void);
 
     extern void HText_setNoCache(HText *text);
     extern BOOL HText_hasNoCacheSet(HText *text);
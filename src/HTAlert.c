@@ -409,6 +409,148 @@ void HTReadProgress(off_t bytes, off_t total)
 #endif
 }
 
+/*
+ * Timing of the phases of loading a document.  The protocol modules call
+ * HTSetTimePhase() as they move from one phase to the next, e.g., from waiting
+ * for a connection to reading the response, and the time since the previous
+ * call is charged to the phase which was current.  The totals for a document
+ * are saved in its anchor, and summed for all documents loaded.
+ */
+static const char *time_phase_names[HT_TIME_PHASES] =
+{
+    "dns",
+    "connect",
+    "tls",
+    "wait",
+    "transfer",
+    "render",
+    "other",
+    "total"
+};
+
+static int timing_depth;	/* nonzero while a document is loading */
+static HTTimePhase timing_phase = tpOther;
+static double timing_start;
+static double timing_mark;
+static double timing_this[HT_TIME_PHASES];
+static double timing_sum[HT_TIME_PHASES];
+static long timing_docs;
+
+/*
+ * Returns the current time in seconds, as precisely as we can tell it.
+ */
+double HTTimeNow(void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+    struct timeval tv;
+
+    gettimeofday(&tv, (struct timezone *) 0);
+    return (double) tv.tv_sec + (double) tv.tv_usec / 1000000.;
+#else
+#if defined(HAVE_FTIME) && defined(HAVE_SYS_TIMEB_H)
+    struct timeb tb;
+
+    ftime(&tb);
+    return tb.time + (double) tb.millitm / 1000;
+#else
+    return (double) time((time_t *) 0);
+#endif
+#endif
+}
+
+const char *HTTimePhaseName(HTTimePhase phase)
+{
+    return time_phase_names[phase];
+}
+
+/*
+ * Switch to a new phase, returning the previous one.
+ */
+HTTimePhase HTSetTimePhase(HTTimePhase phase)
+{
+    HTTimePhase result = timing_phase;
+
+    if (timing_depth > 0) {
+	double now = HTTimeNow();
+
+	timing_this[timing_phase] += now - timing_mark;
+	timing_mark = now;
+    }
+    timing_phase = phase;
+    return result;
+}
+
+/*
+ * Begin timing a document.  Nested loads are charged to the outermost one.
+ */
+void HTStartTiming(void)
+{
+    if (timing_depth++ == 0) {
+	memset(timing_this, 0, sizeof(timing_this));
+	timing_phase = tpOther;
+	timing_start = timing_mark = HTTimeNow();
+    }
+}
+
+static void print_timings(FILE *fp, double *timings)
+{
+    int n;
+
+    for (n = 0; n < HT_TIME_PHASES; ++n) {
+	fprintf(fp, " %s=%.6f", time_phase_names[n], timings[n]);
+    }
+}
+
+/*
+ * Finish timing a document, saving the result in its anchor.  With -timing,
+ * a line is written to stderr for each document if curses is not in use.
+ */
+void HTFinishTiming(HTParentAnchor *anchor, int status)
+{
+    off_t bytes = 0;
+    int n;
+
+    if (timing_depth <= 0 || --timing_depth > 0)
+	return;
+
+    HTSetTimePhase(tpOther);
+    timing_this[tpTotal] = timing_mark - timing_start;
+    for (n = 0; n < HT_TIME_PHASES; ++n) {
+	timing_sum[n] += timing_this[n];
+    }
+    ++timing_docs;
+
+    if (anchor != 0) {
+	memcpy(anchor->timings, timing_this, sizeof(anchor->timings));
+	bytes = ((anchor->actual_length > 0)
+		 ? anchor->actual_length
+		 : anchor->content_length);
+    }
+    if (show_timings && !LYCursesON) {
+	fflush(stdout);
+	fprintf(stderr, "timing: status=%d", status);
+	print_timings(stderr, timing_this);
+	fprintf(stderr, " bytes=%" PRI_off_t " url=%s\n",
+		CAST_off_t (bytes),
+		(anchor != 0) ? anchor->address : "");
+	fflush(stderr);
+    }
+}
+
+/*
+ * With -timing, summarize the documents loaded, e.g., by -traversal.
+ */
+void HTShowTimings(void)
+{
+    if (show_timings && timing_docs != 0) {
+	fflush(stdout);
+	fprintf(stderr, "timing: documents=%ld", timing_docs);
+	print_timings(stderr, timing_sum);
+	fputc('\n', stderr);
+	fflush(stderr);
+    }
+}
+
 static BOOL conf_cancelled = NO;	/* used by HTConfirm only - kw */
 
 BOOL HTLastConfirmCancelled(void)
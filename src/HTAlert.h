@@ -12,6 +12,7 @@
 #define HTALERT_H 1
 
 #include <LYCookie.h>
+#include <HTAnchor.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,6 +48,15 @@ extern "C" {
     extern void HTProgress(const char *Msg);
     extern void HTReadProgress(off_t bytes, off_t total);
 
+/*      Time the phases of loading a document
+ */
+    extern const char *HTTimePhaseName(HTTimePhase phase);
+    extern HTTimePhase HTSetTimePhase(HTTimePhase phase);
+    extern double HTTimeNow(void);
+    extern void HTStartTiming(void);
+    extern void HTFinishTiming(HTParentAnchor *anchor, int status);
+    extern void HTShowTimings(void);
+
 #define _HTProgress(msg)	mustshow = TRUE, HTProgress(msg)
 
 /*
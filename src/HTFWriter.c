@@ -222,6 +222,16 @@ static void HTFWriter_free(HTStream *me)
 			path[len - 4] = '\0';
 			(void) remove(path);
 		    }
+		} else if (len > 4 && !strcasecomp(&path[len - 3], "zst")) {
+#ifdef USE_ZSTD
+		    if (!skip_loadfile) {
+			use_zread = YES;
+		    } else
+#endif /* USE_ZSTD */
+		    {
+			path[len - 4] = '\0';
+			(void) remove(path);
+		    }
 		} else if (len > 2 && !strcasecomp(&path[len - 1], "Z")) {
 		    path[len - 2] = '\0';
 		    (void) remove(path);
@@ -455,6 +465,11 @@ static void HTFWriter_free(HTStream *me)
 	if (me->anchor->FileCache)
 	    (void) remove(me->anchor->FileCache);
 	FREE(me);
+	/*
+	 * With -batch, go on to the next document.
+	 */
+	if (dump_batch_file != NULL)
+	    return;
 #ifdef USE_PERSISTENT_COOKIES
 	/*
 	 * We want to save cookies picked up when in source mode.  ...
@@ -525,6 +540,17 @@ static const HTStreamClass HTFWriter =	/* As opposed to print etc */
 /*	Subclass-specific Methods
  *	-------------------------
  */
+
+/*
+ * If the stream is a file writer, return its file.
+ */
+FILE *HTFWriter_file(HTStream *me)
+{
+    if (me != NULL && me->isa == &HTFWriter)
+	return me->fp;
+    return NULL;
+}
+
 HTStream *HTFWriter_new(FILE *fp)
 {
     HTStream *me;
@@ -989,6 +1015,25 @@ HTStream *HTSaveToFile(HTPresentation *pres,
     return ret_obj;
 }
 
+/*
+ * Check if the uncompressed data would be passed to an external viewer,
+ * rather than presented by one of our own streams.
+ */
+static BOOL use_viewer(HTPresentation *Pres, HTParentAnchor *anchor GCC_UNUSED)
+{
+    return (BOOL) (Pres->command != NULL
+		   && !dump_output_immediately && !traversal
+#if defined(EXEC_LINKS) || defined(EXEC_SCRIPTS)
+		   && (Pres->quality < 999.0 ||
+		       (!no_exec &&	/* allowed exec link or script ? */
+			(local_exec ||
+			 (local_exec_on_local_files &&
+			  (LYJumpFileURL ||
+			   !StrNCmp(anchor->address, "file://localhost", 16))))))
+#endif /* EXEC_LINKS || EXEC_SCRIPTS */
+	);
+}
+
 /*	Set up stream for uncompressing - FM
  *	-------------------------------
  */
@@ -1003,6 +1048,7 @@ HTStream *HTCompressed(HTPresentation *pres,
     HTPresentation *Pnow = NULL;
     int n, i;
     BOOL can_present = FALSE;
+    BOOL can_decode = FALSE;
     char fnam[LY_MAXPATH];
     char temp[LY_MAXPATH];	/* actually stores just a suffix */
     const char *suffix;
@@ -1073,6 +1119,13 @@ HTStream *HTCompressed(HTPresentation *pres,
 		    compress_suffix = "bz2";
 		}
 		break;
+	    case cftZstd:
+		if ((program = HTGetProgramPath(ppZSTD)) != NULL) {
+		    StrAllocCopy(uncompress_mask, program);
+		    StrAllocCat(uncompress_mask, " -d -q --rm %s");
+		    compress_suffix = "zst";
+		}
+		break;
 	    case cftCompress:
 		if ((program = HTGetProgramPath(ppUNCOMPRESS)) != NULL) {
 		    /*
@@ -1088,8 +1141,36 @@ HTStream *HTCompressed(HTPresentation *pres,
 	    }
 	}
     }
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
+    /*
+     * If we present the data ourselves, zlib, bzlib or libzstd can uncompress
+     * it as it arrives, without the external program.
+     */
+    if (can_present && !use_viewer(Pres, anchor)) {
+	switch (HTEncodingToCompressType(anchor->content_encoding)) {
+#ifdef USE_ZLIB
+	case cftGzip:
+	case cftDeflate:
+	    can_decode = TRUE;
+	    break;
+#endif
+#ifdef USE_BZLIB
+	case cftBzip2:
+	    can_decode = TRUE;
+	    break;
+#endif
+#ifdef USE_ZSTD
+	case cftZstd:
+	    can_decode = TRUE;
+	    break;
+#endif
+	default:
+	    break;
+	}
+    }
+#endif
     if (can_present == FALSE ||	/* no presentation mapping */
-	uncompress_mask == NULL ||	/* not gzip or compress */
+	(uncompress_mask == NULL && !can_decode) ||	/* not gzip or compress */
 	StrChr(anchor->content_type, ';') ||	/* wrong charset */
 	HTOutputFormat == HTAtom_for("www/download") ||		/* download */
 	!strcasecomp(pres->rep_out->name, "www/download") ||	/* download */
@@ -1121,6 +1202,31 @@ HTStream *HTCompressed(HTPresentation *pres,
 	return me;
     }
 
+#if defined(USE_ZLIB) || defined(USE_BZLIB) || defined(USE_ZSTD)
+    /*
+     * Rather than saving the data to a temporary file and uncompressing that,
+     * pass it through a decoder stream so it can be displayed while loading.
+     */
+    if (can_decode) {
+	HTStream *target;
+
+	me = NULL;
+	format = HTAtom_for(anchor->content_type);
+	if ((target = HTStreamStack(format, pres->rep_out, sink, anchor)) != 0) {
+	    if ((me = HTDecoderStream(anchor->content_encoding, target)) != 0) {
+		CTRACE((tfp, "HTCompressed: uncompressing %s as it arrives\n",
+			anchor->content_encoding));
+	    } else {
+		(*target->isa->_abort) (target, NULL);
+	    }
+	}
+	if (me != NULL || uncompress_mask == NULL) {
+	    FREE(uncompress_mask);
+	    return me;
+	}
+    }
+#endif
+
     /*
      * Set up the stream structure for uncompressing and then handling based on
      * the uncompressed Content-Type.- FM
@@ -1203,16 +1309,7 @@ HTStream *HTCompressed(HTPresentation *pres,
      * don't set it under conditions where HTSaveAndExecute would disallow
      * execution of the command.  - KW
      */
-    if (!dump_output_immediately && !traversal
-#if defined(EXEC_LINKS) || defined(EXEC_SCRIPTS)
-	&& (Pres->quality < 999.0 ||
-	    (!no_exec &&	/* allowed exec link or script ? */
-	     (local_exec ||
-	      (local_exec_on_local_files &&
-	       (LYJumpFileURL ||
-		!StrNCmp(anchor->address, "file://localhost", 16))))))
-#endif /* EXEC_LINKS || EXEC_SCRIPTS */
-	) {
+    if (use_viewer(Pres, anchor)) {
 	StrAllocCopy(me->viewer_command, Pres->command);
     }
 
@@ -1229,6 +1326,16 @@ HTStream *HTCompressed(HTPresentation *pres,
 	StrAllocCopy(me->end_command, "");
     } else
 #endif
+#ifdef USE_ZSTD
+    if (!strcmp(compress_suffix, "zst")	/* must be zstd */
+	&& !me->viewer_command) {
+	/*
+	 * We won't call zstd externally, so we don't need to supply a command
+	 * for it.
+	 */
+	StrAllocCopy(me->end_command, "");
+    } else
+#endif
 #ifdef USE_ZLIB
 	/* FIXME: allow deflate here, e.g., 'z' */
 	if (compress_suffix[0] == 'g'	/* must be gzip */
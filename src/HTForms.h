@@ -55,7 +55,8 @@ extern "C" {
 	const char *accept_cs;
     } InputFieldData;
 
-/* The OptionType structure is for a linked list of option entries
+/* The OptionType structure is for a linked list of option entries, which are
+ * allocated in the document's pool.
  */
     typedef struct _OptionType {
 	char *name;		/* the name of the entry */
@@ -83,6 +84,9 @@ extern "C" {
 	int hrange;		/* high numerical range */
 	int lrange;		/* low numerical range */
 	OptionType *select_list;	/* array of option choices */
+	OptionType *select_last;	/* ...its last entry */
+	int select_count;	/* ...the number of entries */
+	char **select_names;	/* ...their names, for the popup */
 	char *submit_action;	/* form's action */
 	int submit_method;	/* form's method */
 	char *submit_enctype;	/* form's entype */
@@ -1147,6 +1147,9 @@ void HTFileInit(void)
 	SET_SUFFIX1(".bz2",	"application/x-bzip2",		"binary");
 	SET_SUFFIX1(".bz2",	"application/bzip2",		"binary");
 
+	SET_SUFFIX1(".zst",	"application/x-zstd",		"binary");
+	SET_SUFFIX1(".zst",	"application/zstd",		"binary");
+
 #ifdef TRADITIONAL_SUFFIXES
 	SET_SUFFIX1(".uu",	"application/x-UUencoded",	"8bit");
 
@@ -194,6 +194,8 @@ void actually_set_style(HTStructured * me)
 						 UCT_STAGE_HTEXT));
 	me->text = HText_new2(me->node_anchor, me->target);
 	HText_beginAppend(me->text);
+	if (me->hasImages)
+	    HText_setHasImages(me->text);
 	HText_setStyle(me->text, me->new_style);
 	me->in_word = NO;
 	LYCheckForContentBase(me);
@@ -948,9 +950,31 @@ static void clear_objectdata(HTStructured * me)
     }
 }
 
+/*
+ * Resolve a reference against the BASE or the document's address, reusing
+ * the scanned form of either.
+ */
+static char *HTML_parse_all(HTStructured * me,
+			    const char *aName,
+			    const char *relatedName)
+{
+    char *result;
+
+    if (relatedName == me->base_href) {
+	result = HTParseRelative(aName, &(me->parsed_base),
+				 relatedName, PARSE_ALL);
+    } else if (relatedName == me->node_anchor->address) {
+	result = HTParseRelative(aName, &(me->node_anchor->parsed_address),
+				 relatedName, PARSE_ALL);
+    } else {
+	result = HTParse(aName, relatedName, PARSE_ALL);
+    }
+    return result;
+}
+
 #define HTParseALL(pp,pconst)  \
 	{ char* free_me = *pp; \
-	  *pp = HTParse(*pp, pconst, PARSE_ALL); \
+	  *pp = HTML_parse_all(me, *pp, pconst); \
 	  FREE(free_me);       \
 	}
 
@@ -1194,6 +1218,33 @@ static int HTML_start_element(HTStructured * me, int element_number,
     HText_characterStyle(me->text, hcode, STACK_ON);
 #endif /* USE_COLOR_STYLE */
 
+    /*
+     * Note the elements whose rendering depends on the image settings, so
+     * that changing those need not reparse a document which has none.
+     */
+    switch (ElementNumber) {
+    case HTML_APPLET:
+    case HTML_BGSOUND:
+    case HTML_EMBED:
+    case HTML_FIG:
+    case HTML_IMG:
+    case HTML_OBJECT:
+    case HTML_OVERLAY:
+	me->hasImages = TRUE;
+	HText_setHasImages(me->text);
+	break;
+    case HTML_INPUT:
+	if (present && present[HTML_INPUT_TYPE] &&
+	    non_empty(value[HTML_INPUT_TYPE]) &&
+	    !strcasecomp(value[HTML_INPUT_TYPE], "image")) {
+	    me->hasImages = TRUE;
+	    HText_setHasImages(me->text);
+	}
+	break;
+    default:
+	break;
+    }
+
     /*
      * Handle the start tag.  - FM
      */
@@ -1559,6 +1610,11 @@ static int HTML_start_element(HTStructured * me, int element_number,
 					    UCT_SETBY_LINK);
 	    }
 	    UPDATE_STYLE;
+	    if (!intern_flag &&
+		present[HTML_LINK_REL] && value[HTML_LINK_REL] &&
+		!strcasecomp(value[HTML_LINK_REL], "Next")) {
+		HText_setNextLink(me->text, href);
+	    }
 	    if (!HText_hasToolbar(me->text) &&
 		(ID_A = HTAnchor_findChildAndLink(me->node_anchor,	/* Parent */
 						  LYToolbarName,	/* Tag */
@@ -2065,6 +2121,7 @@ static int HTML_start_element(HTStructured * me, int element_number,
 	    }
 	    for (i = 0; i < width; i++)
 		HTML_put_character(me, '_');
+	    HText_setUsesWidth(me->text);
 	    HText_appendCharacter(me->text, '\r');
 	    me->in_word = NO;
 	    me->inP = FALSE;
@@ -7273,6 +7330,7 @@ static void HTML_free(HTStructured * me)
 	 * free anything that might have been allocated.  - FM
 	 */
 	FREE(me->base_href);
+	HTParseFreeBase(&(me->parsed_base));
 	FREE(me->map_address);
 	clear_objectdata(me);
 	FREE(me->xinclude);
@@ -7432,6 +7490,7 @@ static void HTML_free(HTStructured * me)
 	styles[HTML_PRE]->alignment = HT_LEFT;
     }
     FREE(me->base_href);
+    HTParseFreeBase(&(me->parsed_base));
     FREE(me->map_address);
     FREE(me->LastOptionValue);
     clear_objectdata(me);
@@ -7517,6 +7576,7 @@ static void HTML_abort(HTStructured * me, HTError e)
 	styles[HTML_PRE]->alignment = HT_LEFT;
     }
     FREE(me->base_href);
+    HTParseFreeBase(&(me->parsed_base));
     FREE(me->map_address);
     FREE(me->textarea_name);
     FREE(me->textarea_accept_cs);
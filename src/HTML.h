@@ -74,6 +74,7 @@ extern "C" {
 	HTChildAnchor *CurrentA;	/* current HTML_A anchor */
 	int CurrentANum;	/* current HTML_A number */
 	char *base_href;	/* current HTML_BASE href */
+	HTParsedBase *parsed_base;	/* ...for resolving references */
 	char *map_address;	/* current HTML_MAP address */
 
 	HTChunk title;		/* Grow by 128 */
@@ -169,6 +170,7 @@ extern "C" {
 	BOOL inUnderline;
 
 	BOOL needBoldH;
+	BOOL hasImages;		/* seen any element using image settings */
 
 	char *xinclude;		/* if no include strin address passed */
 	/*
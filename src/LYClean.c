@@ -125,6 +125,7 @@ void cleanup_sig(int sig)
 	 */
 	SaveSession();
 #endif /* USE_SESSIONS */
+	LYSaveVisitedLinks();
 	cleanup_files();
     }
 #endif /* NOSIGHUP */
@@ -185,6 +186,7 @@ void cleanup(void)
 #ifdef USE_SESSIONS
     SaveSession();
 #endif /* USE_SESSIONS */
+    LYSaveVisitedLinks();
 
     cleanup_files();
 #ifdef VMS
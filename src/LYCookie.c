@@ -2062,6 +2062,45 @@ void LYLoadCookies(char *cookie_file)
     LYCloseInput(cookie_handle);
 }
 
+/*
+ * Estimate the memory used by the cookie jar, setting cookies to the number
+ * of cookies in it.
+ */
+long LYCookieMemory(long *cookies)
+{
+    HTList *dl, *cl;
+    domain_entry *de;
+    cookie *co;
+    long result = 0;
+
+    *cookies = 0;
+    for (dl = domain_list; dl != NULL; dl = dl->next) {
+	if ((de = (domain_entry *) (dl->object)) == NULL)
+	    continue;
+
+	result += (long) (sizeof(domain_entry) + sizeof(HTList))
+	    + StrMemory(de->domain)
+	    + StrMemory(de->ddomain);
+	for (cl = de->cookie_list; cl != NULL; cl = cl->next) {
+	    if ((co = (cookie *) (cl->object)) == NULL)
+		continue;
+
+	    ++(*cookies);
+	    result += (long) (sizeof(cookie) + sizeof(HTList))
+		+ StrMemory(co->lynxID)
+		+ StrMemory(co->name)
+		+ StrMemory(co->value)
+		+ StrMemory(co->comment)
+		+ StrMemory(co->commentURL)
+		+ StrMemory(co->domain)
+		+ StrMemory(co->ddomain)
+		+ StrMemory(co->PortList)
+		+ StrMemory(co->path);
+	}
+    }
+    return result;
+}
+
 static FILE *NewCookieFile(char *cookie_file)
 {
     CTrace((tfp, "LYStoreCookies: save cookies to %s on exit\n", cookie_file));
@@ -52,6 +52,7 @@ extern "C" {
     extern void LYStoreCookies(char *cookie_file);
     extern void LYLoadCookies(char *cookie_file);
     extern void LYConfigCookies(void);
+    extern long LYCookieMemory(long *cookies);
 
 #ifdef __cplusplus
 }
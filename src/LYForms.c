@@ -31,33 +31,27 @@ static int form_getstr(int cur,
 		       int redraw_only);
 
 /*
- * Returns an array of pointers to the given list
+ * Returns an array of pointers to the names in the field's list of options.
+ * The array is built the first time the popup is shown, and kept with the
+ * field (which frees it) since the list does not change afterwards.
  */
-static char **options_list(OptionType * opt_ptr)
+static char **options_list(FormInfo * form)
 {
-    char **result = 0;
-    size_t len;
-    int pass;
-    OptionType *tmp_ptr;
+    if (form->select_names == 0) {
+	OptionType *tmp_ptr;
+	size_t len = 0;
 
-    for (pass = 0; pass < 2; pass++) {
-	for (tmp_ptr = opt_ptr, len = 0; tmp_ptr != 0; tmp_ptr = tmp_ptr->next) {
-	    if (pass != 0)
-		result[len] = tmp_ptr->name;
-	    len++;
-	}
-	if (pass == 0) {
-	    len++;
-	    result = typecallocn(char *, len);
+	form->select_names = typecallocn(char *, (size_t) form->select_count + 1);
 
-	    if (result == 0)
-		outofmem(__FILE__, "options_list");
-	} else {
-	    result[len] = 0;
+	if (form->select_names == 0)
+	    outofmem(__FILE__, "options_list");
+
+	for (tmp_ptr = form->select_list; tmp_ptr != 0; tmp_ptr = tmp_ptr->next) {
+	    form->select_names[len++] = tmp_ptr->name;
 	}
+	form->select_names[len] = 0;
     }
-
-    return result;
+    return form->select_names;
 }
 
 int change_form_link_ex(int cur,
@@ -73,8 +67,6 @@ int change_form_link_ex(int cur,
     int newdoc_changed = 0;
     int c = DO_NOTHING;
     int title_adjust = (no_title ? -TITLE_LINES : 0);
-    char **my_data = 0;
-
     /*
      * If there is no form to perform action on, don't do anything.
      */
@@ -83,7 +75,6 @@ int change_form_link_ex(int cur,
     }
     link_name = form->name;
     link_value = form->value;
-    my_data = options_list(form->select_list);
 
     /*
      * Move to the link position.
@@ -109,7 +100,7 @@ int change_form_link_ex(int cur,
 	    (void) LYhandlePopupList(form->num_value,
 				     links[cur].ly,
 				     links[cur].lx,
-				     (STRING2PTR) my_data,
+				     (STRING2PTR) options_list(form),
 				     form->size,
 				     form->size_l,
 				     FormIsReadonly(form),
@@ -120,7 +111,7 @@ int change_form_link_ex(int cur,
 	form->num_value = LYhandlePopupList(form->num_value,
 					    links[cur].ly,
 					    links[cur].lx,
-					    (STRING2PTR) my_data,
+					    (STRING2PTR) options_list(form),
 					    form->size,
 					    form->size_l,
 					    FormIsReadonly(form),
@@ -331,7 +322,6 @@ int change_form_link_ex(int cur,
 	LYforce_no_cache = FALSE;
 	reloading = FALSE;
     }
-    FREE(my_data);
     return (c);
 }
 
@@ -262,9 +262,11 @@ extern "C" {
     extern char *LYRequestTitle;	/* newdoc.title in calls to getfile() */
     extern char *LYTransferName;	/* abbreviation for Kilobytes */
     extern char *LynxHome;
+    extern char *dump_batch_file;	/* list of URLs to dump, for -batch */
 #ifdef USE_SESSIONS
     extern char *LYSessionFile;	/* file for auto-session */
     extern char *session_file;	/* file for -session= */
+    extern char *LYVisitedLinksFile;	/* file for persistent visited links */
     extern char *sessionin_file;	/* file for -sessionin= */
     extern char *sessionout_file;	/* file for -sessionout= */
 #endif
@@ -401,6 +403,8 @@ extern "C" {
     extern BOOLEAN historical_comments;
     extern BOOLEAN html5_charsets;
     extern BOOLEAN minimal_comments;
+    extern BOOLEAN show_memstats;
+    extern BOOLEAN show_timings;
     extern BOOLEAN soft_dquotes;
 
 #ifdef USE_SOURCE_CACHE
@@ -552,6 +556,9 @@ extern "C" {
     extern BOOLEAN LYNoCc;
     extern BOOLEAN LYNonRestartingSIGWINCH;
     extern BOOLEAN LYPreparsedSource;	/* Show source as preparsed?     */
+#ifdef NSL_FORK
+    extern BOOLEAN LYPrefetchHosts;	/* Look up links' hosts ahead?   */
+#endif
     extern BOOLEAN LYPrependBaseToSource;
     extern BOOLEAN LYPrependCharsetToSource;
     extern BOOLEAN LYQuitDefaultYes;
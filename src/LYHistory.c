@@ -43,6 +43,23 @@ static VisitedLink *Latest_tree;
 static VisitedLink *First_tree;
 static VisitedLink *Last_by_first;
 
+/*
+ * The addresses of visited links are hashed, so that LYAddVisitedLink need
+ * not compare each one to find whether a page was visited before.
+ */
+#define VISITED_HASH_SIZE 4093	/* Arbitrary prime */
+
+static VisitedLink **Visited_Hash;
+static HTList *Visited_Links_tail;	/* last node of Visited_Links */
+static BOOLEAN Visited_Links_loaded = FALSE;
+static int Visited_Links_unsaved = 0;	/* added since VISITED_LINKS_FILE */
+
+/*
+ * New links are appended to VISITED_LINKS_FILE.  When it grows past this
+ * size, it is rewritten with the newest links which fill half of it.
+ */
+#define VISITED_FILE_LIMIT (256 * 1024)
+
 int nhist_extra;
 
 #ifdef LY_FIND_LEAKS
@@ -71,6 +88,8 @@ static void Visited_Links_free(void)
     }
     HTList_delete(Visited_Links);
     Visited_Links = NULL;
+    Visited_Links_tail = NULL;
+    FREE(Visited_Hash);
     Latest_last.prev_latest = &Latest_first;
     Latest_first.next_latest = &Latest_last;
     Last_by_first = Latest_tree = First_tree = 0;
@@ -91,6 +110,238 @@ static void trace_history(const char *tag)
 #define trace_history(tag)	/* nothing */
 #endif /* DEBUG */
 
+static unsigned visited_hash(const char *address)
+{
+    unsigned hash = 0;
+
+    while (*address != '\0')
+	hash = (hash * 31) + UCH(*address++);
+    return (hash % VISITED_HASH_SIZE);
+}
+
+static VisitedLink *find_visited(const char *address)
+{
+    VisitedLink *vl;
+
+    for (vl = Visited_Hash[visited_hash(address)]; vl != NULL; vl = vl->next_hash) {
+	if (!strcmp(NonNull(vl->address), address))
+	    break;
+    }
+    return vl;
+}
+
+static void init_visited(void)
+{
+    if (!Visited_Links) {
+	Visited_Links = HTList_new();
+	Visited_Links_tail = Visited_Links;
+	Visited_Hash = typecallocn(VisitedLink *, VISITED_HASH_SIZE);
+	if (Visited_Hash == NULL)
+	    outofmem(__FILE__, "init_visited");
+#ifdef LY_FIND_LEAKS
+	atexit(Visited_Links_free);
+#endif
+	Latest_last.prev_latest = &Latest_first;
+	Latest_first.next_latest = &Latest_last;
+	Latest_last.next_latest = NULL;		/* Find bugs quick! */
+	Latest_first.prev_latest = NULL;
+	Last_by_first = Latest_tree = First_tree = NULL;
+    }
+}
+
+/*
+ * Add a link to the hash index and to the end of the first-visited list.
+ */
+static VisitedLink *new_visited(const char *address, const char *title)
+{
+    VisitedLink *tmp;
+    unsigned hash = visited_hash(address);
+
+    if ((tmp = typecalloc(VisitedLink)) == NULL)
+	outofmem(__FILE__, "new_visited");
+
+    assert(tmp != NULL);
+
+    StrAllocCopy(tmp->address, address);
+    LYformTitle(&(tmp->title), title);
+
+    tmp->next_hash = Visited_Hash[hash];
+    Visited_Hash[hash] = tmp;
+
+    HTList_addObject(Visited_Links_tail, tmp);	/* At end */
+    Visited_Links_tail = Visited_Links_tail->next;
+    return tmp;
+}
+
+/*
+ * Read the links saved by LYSaveVisitedLinks in an earlier session, and put
+ * them before the ones visited in this session.  That is done only when the
+ * whole list is needed, so that it does not delay startup.
+ */
+static void LYLoadVisitedLinks(void)
+{
+    FILE *fp;
+    char *buffer = NULL;
+    HTList *saved_tail;
+    HTList *saved_next;
+    VisitedLink *oldest;
+    VisitedLink *first = NULL;
+    VisitedLink *last = NULL;
+
+    if (Visited_Links_loaded || isEmpty(LYVisitedLinksFile))
+	return;
+    Visited_Links_loaded = TRUE;
+
+    if ((fp = fopen(LYVisitedLinksFile, TXT_R)) == NULL)
+	return;
+    CTRACE((tfp, "LYLoadVisitedLinks %s\n", LYVisitedLinksFile));
+
+    /*
+     * Collect the saved links at the end of the list, then move them to the
+     * front.
+     */
+    init_visited();
+    saved_tail = Visited_Links_tail;
+    saved_next = Visited_Links->next;
+    oldest = (VisitedLink *) HTList_objectAt(Visited_Links, 0);
+    while (LYSafeGets(&buffer, fp) != 0) {
+	char *address;
+	char *title;
+	VisitedLink *tmp;
+
+	LYTrimNewline(buffer);
+	if (*buffer == '#'
+	    || (address = StrChr(buffer, ' ')) == NULL)
+	    continue;
+	*address++ = '\0';
+	if ((title = StrChr(address, '\t')) == NULL)
+	    continue;
+	*title++ = '\0';
+	if (*address == '\0' || find_visited(address) != NULL)
+	    continue;
+
+	tmp = new_visited(address, title);
+	tmp->level = atoi(buffer);
+	tmp->saved = TRUE;
+
+	/* The saved links are in tree order, use that for the others */
+	tmp->prev_first = last;
+	tmp->prev_latest = last;
+	if (last != NULL) {
+	    last->next_tree = tmp;
+	    last->next_latest = tmp;
+	} else {
+	    first = tmp;
+	}
+	last = tmp;
+    }
+    LYCloseInput(fp);
+    FREE(buffer);
+
+    if (first != NULL) {
+	if (saved_tail != Visited_Links) {
+	    Visited_Links->next = saved_tail->next;
+	    Visited_Links_tail->next = saved_next;
+	    saved_tail->next = NULL;
+	    Visited_Links_tail = saved_tail;
+	}
+	if (oldest != NULL)
+	    oldest->prev_first = last;
+	else
+	    Last_by_first = last;
+
+	last->next_latest = Latest_first.next_latest;
+	Latest_first.next_latest->prev_latest = last;
+	first->prev_latest = &Latest_first;
+	Latest_first.next_latest = first;
+
+	last->next_tree = First_tree;
+	if (Latest_tree == NULL)
+	    Latest_tree = last;
+	First_tree = first;
+    }
+}
+
+static const char *visited_header = "# lynx visited links\n";
+
+static void write_visited(FILE *fp, VisitedLink *vl)
+{
+    fprintf(fp, "%d %s\t%s\n", vl->level, vl->address, NonNull(vl->title));
+    vl->saved = TRUE;
+}
+
+static long visited_size(VisitedLink *vl)
+{
+    char level[32];
+
+    sprintf(level, "%d", vl->level);
+    return (long) (strlen(level) + strlen(vl->address)
+		   + strlen(NonNull(vl->title)) + 3);
+}
+
+/*
+ * Rewrite the file with the newest of its links, dropping those which were
+ * saved in earlier sessions and have been repeated since.
+ */
+static void trim_visited_file(void)
+{
+    FILE *fp;
+    VisitedLink *vl;
+    long total = 0;
+
+    LYLoadVisitedLinks();
+    for (vl = First_tree; vl != NULL; vl = vl->next_tree)
+	total += visited_size(vl);
+    for (vl = First_tree;
+	 vl != NULL && total > VISITED_FILE_LIMIT / 2;
+	 vl = vl->next_tree)
+	total -= visited_size(vl);
+
+    CTRACE((tfp, "trim_visited_file %s\n", LYVisitedLinksFile));
+    if ((fp = LYNewTxtFile(LYVisitedLinksFile)) == NULL)
+	return;
+
+    fputs(visited_header, fp);
+    for (; vl != NULL; vl = vl->next_tree)
+	write_visited(fp, vl);
+    LYCloseOutput(fp);
+}
+
+/*
+ * Append the links visited in this session, in tree order with their levels,
+ * to those saved for a later session.  Nothing is done if there are none, and
+ * the file is read only if it has become too large.
+ */
+void LYSaveVisitedLinks(void)
+{
+    FILE *fp;
+    VisitedLink *vl;
+    struct stat stat_buf;
+    BOOLEAN is_new;
+
+    if (isEmpty(LYVisitedLinksFile) || Visited_Links_unsaved == 0)
+	return;
+
+    CTRACE((tfp, "LYSaveVisitedLinks %s\n", LYVisitedLinksFile));
+    is_new = (BOOLEAN) (stat(LYVisitedLinksFile, &stat_buf) != 0
+			|| stat_buf.st_size == 0);
+    if ((fp = LYAppendToTxtFile(LYVisitedLinksFile)) == NULL)
+	return;
+
+    if (is_new)
+	fputs(visited_header, fp);
+    for (vl = First_tree; vl != NULL; vl = vl->next_tree) {
+	if (!vl->saved)
+	    write_visited(fp, vl);
+    }
+    LYCloseOutput(fp);
+    Visited_Links_unsaved = 0;
+
+    if (stat(LYVisitedLinksFile, &stat_buf) == 0
+	&& stat_buf.st_size > VISITED_FILE_LIMIT)
+	trim_visited_file();
+}
+
 /*
  * Utility for listing visited links, making any repeated links the most
  * current in the list.  - FM
@@ -98,7 +349,6 @@ static void trace_history(const char *tag)
 void LYAddVisitedLink(DocInfo *doc)
 {
     VisitedLink *tmp;
-    HTList *cur;
     const char *title = (doc->title ? doc->title : NO_TITLE);
 
     if (isEmpty(doc->address)) {
@@ -144,50 +394,30 @@ void LYAddVisitedLink(DocInfo *doc)
 	}
     }
 
-    if (!Visited_Links) {
-	Visited_Links = HTList_new();
-#ifdef LY_FIND_LEAKS
-	atexit(Visited_Links_free);
-#endif
-	Latest_last.prev_latest = &Latest_first;
-	Latest_first.next_latest = &Latest_last;
-	Latest_last.next_latest = NULL;		/* Find bugs quick! */
-	Latest_first.prev_latest = NULL;
-	Last_by_first = Latest_tree = First_tree = NULL;
-    }
+    init_visited();
 
-    cur = Visited_Links;
-    while (NULL != (tmp = (VisitedLink *) HTList_nextObject(cur))) {
-	if (!strcmp(NonNull(tmp->address),
-		    NonNull(doc->address))) {
-	    PrevVisitedLink = PrevActiveVisitedLink = tmp;
-	    /* Already visited.  Update the last-visited info. */
-	    if (tmp->next_latest == &Latest_last)	/* optimization */
-		return;
-
-	    /* Remove from "latest" chain */
-	    tmp->prev_latest->next_latest = tmp->next_latest;
-	    tmp->next_latest->prev_latest = tmp->prev_latest;
-
-	    /* Insert at the end of the "latest" chain */
-	    Latest_last.prev_latest->next_latest = tmp;
-	    tmp->prev_latest = Latest_last.prev_latest;
-	    tmp->next_latest = &Latest_last;
-	    Latest_last.prev_latest = tmp;
+    if ((tmp = find_visited(doc->address)) != NULL) {
+	PrevVisitedLink = PrevActiveVisitedLink = tmp;
+	/* Already visited.  Update the last-visited info. */
+	if (tmp->next_latest == &Latest_last)	/* optimization */
 	    return;
-	}
-    }
 
-    if ((tmp = typecalloc(VisitedLink)) == NULL)
-	outofmem(__FILE__, "LYAddVisitedLink");
+	/* Remove from "latest" chain */
+	tmp->prev_latest->next_latest = tmp->next_latest;
+	tmp->next_latest->prev_latest = tmp->prev_latest;
 
-    assert(tmp != NULL);
+	/* Insert at the end of the "latest" chain */
+	Latest_last.prev_latest->next_latest = tmp;
+	tmp->prev_latest = Latest_last.prev_latest;
+	tmp->next_latest = &Latest_last;
+	Latest_last.prev_latest = tmp;
+	return;
+    }
 
-    StrAllocCopy(tmp->address, doc->address);
-    LYformTitle(&(tmp->title), title);
+    tmp = new_visited(doc->address, title);
+    ++Visited_Links_unsaved;
 
     /* First-visited chain */
-    HTList_appendObject(Visited_Links, tmp);	/* At end */
     tmp->prev_first = Last_by_first;
     Last_by_first = tmp;
 
@@ -821,12 +1051,13 @@ int LYShowVisitedLinks(char **newfile)
     int x, tot;
     FILE *fp0;
     VisitedLink *vl;
-    HTList *cur = Visited_Links;
+    HTList *cur;
     int offset;
     int ret = 0;
     const char *arrow, *post_arrow;
 
-    if (!cur)
+    LYLoadVisitedLinks();
+    if ((cur = Visited_Links) == NULL)
 	return (-1);
 
     if ((fp0 = InternalPageFP(tempfile, TRUE)) == 0)
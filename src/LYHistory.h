@@ -18,6 +18,7 @@ extern "C" {
     extern int LYpush(DocInfo *doc, int force_push);
     extern int showhistory(char **newfile);
     extern void LYAddVisitedLink(DocInfo *doc);
+    extern void LYSaveVisitedLinks(void);
     extern void LYAllocHistory(int entries);
     extern void LYFreePostData(DocInfo *data);
     extern void LYFreeDocInfo(DocInfo *data);
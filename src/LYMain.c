@@ -41,6 +41,9 @@
 #include <LYPrettySrc.h>
 #include <LYShowInfo.h>
 #include <LYHistory.h>
+#include <GridText.h>
+
+#include <www_wait.h>
 
 #ifdef VMS
 #include <HTFTP.h>
@@ -228,6 +231,8 @@ BOOLEAN minimal_comments = FALSE;
 BOOLEAN number_fields_on_left = TRUE;
 BOOLEAN number_links_on_left = TRUE;
 BOOLEAN recent_sizechange = FALSE;	/* the window size changed recently? */
+BOOLEAN show_memstats = FALSE;	/* -memstats reports memory used */
+BOOLEAN show_timings = FALSE;	/* -timing reports time spent loading */
 BOOLEAN soft_dquotes = FALSE;
 BOOLEAN unique_urls = FALSE;
 BOOLEAN use_underscore = SUBSTITUTE_UNDERSCORES;
@@ -444,6 +449,7 @@ char *anonftp_password = NULL;	/* anonymous ftp password (default: email) */
 char *authentication_info[2] =
 {NULL, NULL};			/* Id:Password for protected documents */
 char *bookmark_page = NULL;	/* the name of the default bookmark page */
+char *dump_batch_file = NULL;	/* list of URLs to dump, for -batch */
 char *editor = NULL;		/* the name of the current editor */
 char *form_get_data = NULL;	/* User data for get form */
 char *form_post_data = NULL;	/* User data for post form */
@@ -480,6 +486,7 @@ BOOLEAN LYAutoSession = FALSE;	/* enable/disable auto saving/restoring of */
 				/* session */
 char *LYSessionFile = NULL;	/* the session file from lynx.cfg */
 char *session_file = NULL;	/* the current session file */
+char *LYVisitedLinksFile = NULL;	/* persistent visited links */
 char *sessionin_file = NULL;	/* only resume session from this file */
 char *sessionout_file = NULL;	/* only save session to this file */
 short session_limit = 250;	/* maximal number of entries saved per */
@@ -570,6 +577,9 @@ BOOLEAN LYStripDotDotURLs = TRUE;	/* Try to fix ../ in some URLs? */
 BOOLEAN LYForceSSLCookiesSecure = FALSE;
 BOOLEAN LYNoCc = FALSE;
 BOOLEAN LYPreparsedSource = FALSE;	/* Show source as preparsed? */
+#ifdef NSL_FORK
+BOOLEAN LYPrefetchHosts = FALSE;	/* Look up links' hosts ahead? */
+#endif
 BOOLEAN LYPrependBaseToSource = TRUE;
 BOOLEAN LYPrependCharsetToSource = TRUE;
 BOOLEAN LYQuitDefaultYes = QUIT_DEFAULT_YES;
@@ -667,6 +677,12 @@ HTList *positionable_editor = NULL;
 static char *nonoption = 0;
 #endif
 
+#if defined(UNIX) && defined(HAVE_WAITPID)
+/* if set then -batch can fork processes to dump several URLs at once */
+#define USE_BATCH_JOBS 1
+static int dump_batch_jobs = 1;	/* -batch_jobs */
+#endif
+
 #ifndef OPTNAME_ALLOW_DASHES
 /* if set, then will allow dashes and underscores to be used interchangeable
    in commandline option's names - VH */
@@ -799,6 +815,7 @@ static void free_lynx_globals(void)
     FREE(LYCookieFile);
     FREE(LYCookieSaveFile);
 #endif
+    FREE(LYVisitedLinksFile);
     FREE(LYCookieAcceptDomains);
     FREE(LYCookieRejectDomains);
     FREE(LYCookieLooseCheckDomains);
@@ -851,6 +868,7 @@ static void free_lynx_globals(void)
 #if EXTENDED_STARTFILE_RECALL
     FREE(nonoption);
 #endif
+    FREE(dump_batch_file);
     LYFreeStringList(positionable_editor);
 
     return;
@@ -1000,6 +1018,290 @@ static void SetLocale(void)
     LYSetTextDomain();
 }
 
+static HTFormat batch_format;	/* output format for each -batch URL */
+static BOOLEAN batch_html_mode;	/* -force_html setting for each one */
+
+/*
+ * Dump one URL from a -batch list, to the target file if one was given, or
+ * else to the standard output after a "==> URL <==" line.
+ */
+static int dump_batch_url(char *url, char *target, BOOLEAN first)
+{
+    FILE *ofp = NULL;
+    int saved_stdout = -1;
+    int status;
+
+    fflush(stdout);
+    if (*target != '\0') {
+	if ((ofp = LYNewTxtFile(target)) == NULL ||
+	    (saved_stdout = dup(fileno(stdout))) < 0 ||
+	    dup2(fileno(ofp), fileno(stdout)) < 0) {
+	    fprintf(stderr, "%s: %s\n", target, LYStrerror(errno));
+	    if (ofp != NULL)
+		LYCloseOutput(ofp);
+	    if (saved_stdout >= 0)
+		close(saved_stdout);
+	    return EXIT_FAILURE;
+	}
+    } else {
+	if (!first)
+	    printf("\n");
+	printf("==> %s <==\n", url);
+    }
+
+    /*
+     * mainloop resets these after each document.
+     */
+    HTOutputFormat = batch_format;
+    LYforce_HTML_mode = batch_html_mode;
+    dump_server_status = 0;
+
+    /*
+     * Make the URL absolute as for a startfile, and do not fall back to the
+     * homepage if it cannot be loaded.
+     */
+    StrAllocCopy(startfile, url);
+    LYEnsureAbsoluteURL(&startfile, "STARTFILE", FALSE);
+    StrAllocCopy(homepage, startfile);
+    CTRACE((tfp, "batch dumping %s\n", startfile));
+    status = mainloop();
+    if (status == EXIT_SUCCESS &&
+	HTMainText != NULL &&
+	!no_list &&
+	!dump_links_inline &&
+	!crawl)			/* For -crawl it has already been done! */
+	printlist(stdout, FALSE);
+
+    /*
+     * Free the document (and its anchors, if nothing else refers to them)
+     * and its image maps before going on to the next one.
+     */
+    HTuncache_current_document();
+    LYLynxMaps_free();
+
+    fflush(stdout);
+    if (ofp != NULL) {
+	dup2(saved_stdout, fileno(stdout));
+	close(saved_stdout);
+	LYCloseOutput(ofp);
+    }
+    return status;
+}
+
+#ifdef USE_BATCH_JOBS
+/*
+ * With -batch_jobs, each URL is dumped by a child process forked from this
+ * one after it has been initialized.  The children write what would go to the
+ * standard output into temporary files, which are copied out in the order the
+ * URLs were listed.
+ */
+typedef struct {
+    int pid;
+    int status;
+    BOOLEAN done;
+    char output[LY_MAXPATH];	/* the child's standard output, if any */
+} BatchJob;
+
+static HTList *batch_jobs = NULL;	/* in the order they were started */
+static int batch_running = 0;
+
+static int start_batch_job(char *url, char *target, BOOLEAN first)
+{
+    BatchJob *job = typecalloc(BatchJob);
+    FILE *ofp = NULL;
+    int status;
+
+    if (job == NULL)
+	outofmem(__FILE__, "start_batch_job");
+
+    if (*target == '\0' &&
+	(ofp = LYOpenTemp(job->output, TEXT_SUFFIX, "w")) == NULL) {
+	FREE(job);
+	return EXIT_FAILURE;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    switch (job->pid = fork()) {
+    case -1:
+	fprintf(stderr, "%s: %s\n", url, LYStrerror(errno));
+	if (ofp != NULL) {
+	    LYCloseTempFP(ofp);
+	    (void) LYRemoveTemp(job->output);
+	}
+	FREE(job);
+	return EXIT_FAILURE;
+
+    case 0:			/* child */
+	if (ofp != NULL)
+	    dup2(fileno(ofp), fileno(stdout));
+	status = dump_batch_url(url, target, first);
+	fflush(stdout);
+	fflush(stderr);
+	/* leave atexit cleanup, e.g., of temporary files, to the parent */
+	_exit(status);
+	/*NOTREACHED */
+
+    default:			/* parent */
+	if (ofp != NULL)
+	    LYCloseTempFP(ofp);
+	CTRACE((tfp, "batch job %d for %s\n", job->pid, url));
+	if (batch_jobs == NULL)
+	    batch_jobs = HTList_new();
+	HTList_appendObject(batch_jobs, job);
+	++batch_running;
+	break;
+    }
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Wait for one of the running jobs to finish, and record its status.
+ */
+static void wait_batch_job(void)
+{
+    HTList *cur = batch_jobs;
+    BatchJob *job;
+    int pid;
+
+#ifdef HAVE_TYPE_UNIONWAIT
+    union wait wstatus;
+
+#else
+    int wstatus;
+#endif
+
+    while ((pid = waitpid(-1, &wstatus, 0)) == -1) {
+#ifdef EINTR
+	if (errno == EINTR)
+	    continue;
+#endif /* EINTR */
+	break;
+    }
+    while ((job = (BatchJob *) HTList_nextObject(cur)) != NULL) {
+	if (job->done)
+	    continue;
+	if (pid == -1) {	/* lost track of the children */
+	    job->done = TRUE;
+	    job->status = EXIT_FAILURE;
+	    --batch_running;
+	} else if (job->pid == pid) {
+	    job->done = TRUE;
+	    job->status = (WIFEXITED(wstatus)
+			   ? WEXITSTATUS(wstatus)
+			   : EXIT_FAILURE);
+	    --batch_running;
+	    break;
+	}
+    }
+}
+
+/*
+ * Copy the output of the finished jobs at the front of the list to the
+ * standard output, keeping the order of the URLs.
+ */
+static int flush_batch_jobs(void)
+{
+    BatchJob *job;
+    FILE *fp;
+    char buffer[BUFSIZ];
+    size_t len;
+    int result = EXIT_SUCCESS;
+
+    while ((job = (BatchJob *) HTList_objectAt(batch_jobs, 0)) != NULL
+	   && job->done) {
+	HTList_removeLastObject(batch_jobs);
+	if (*job->output != '\0') {
+	    if ((fp = fopen(job->output, TXT_R)) != NULL) {
+		while ((len = fread(buffer, sizeof(char), sizeof(buffer), fp)) > 0)
+		    fwrite(buffer, sizeof(char), len, stdout);
+		fclose(fp);
+	    }
+	    (void) LYRemoveTemp(job->output);
+	}
+	if (job->status != EXIT_SUCCESS)
+	    result = job->status;
+	FREE(job);
+    }
+    fflush(stdout);
+    return result;
+}
+#endif /* USE_BATCH_JOBS */
+
+/*
+ * Dump the URLs listed in a -batch file (or the standard input, for "-"),
+ * reusing this process's configuration and cookies rather than starting lynx
+ * once for each.  Each line gives a URL, optionally followed by the name of a
+ * file for its output.  Other documents are written to the standard output,
+ * each preceded by a "==> URL <==" line.  Blank lines and lines beginning with
+ * "#" are ignored.
+ */
+static int dump_batch(const char *listname)
+{
+    FILE *fp;
+    char *buffer = NULL;
+    char *url;
+    char *target;
+    int status;
+    int result = EXIT_SUCCESS;
+    int count = 0;
+
+    if (!strcmp(listname, "-")) {
+	fp = stdin;
+    } else if ((fp = fopen(listname, TXT_R)) == NULL) {
+	fprintf(stderr, "%s: %s\n", listname, LYStrerror(errno));
+	return EXIT_FAILURE;
+    }
+
+    batch_format = HTOutputFormat;
+    batch_html_mode = LYforce_HTML_mode;
+
+    while (LYSafeGets(&buffer, fp) != NULL) {
+	url = LYSkipBlanks(LYTrimNewline(buffer));
+	if (*url == '\0' || *url == '#')
+	    continue;
+	target = LYSkipNonBlanks(url);
+	if (*target != '\0') {
+	    *target++ = '\0';
+	    target = LYSkipBlanks(target);
+	    LYTrimTrailing(target);
+	}
+#ifdef USE_BATCH_JOBS
+	if (dump_batch_jobs > 1) {
+	    while (batch_running >= dump_batch_jobs) {
+		wait_batch_job();
+		if ((status = flush_batch_jobs()) != EXIT_SUCCESS)
+		    result = status;
+	    }
+	    status = start_batch_job(url, target,
+				     (BOOLEAN) (*target == '\0' && !count));
+	} else
+#endif
+	    status = dump_batch_url(url, target,
+				    (BOOLEAN) (*target == '\0' && !count));
+	if (*target == '\0')
+	    ++count;
+	if (status != EXIT_SUCCESS)
+	    result = status;
+    }
+#ifdef USE_BATCH_JOBS
+    while (batch_running > 0) {
+	wait_batch_job();
+	if ((status = flush_batch_jobs()) != EXIT_SUCCESS)
+	    result = status;
+    }
+    if ((status = flush_batch_jobs()) != EXIT_SUCCESS)
+	result = status;
+    HTList_delete(batch_jobs);
+    batch_jobs = NULL;
+#endif
+    FREE(buffer);
+    if (fp != stdin)
+	fclose(fp);
+
+    return result;
+}
+
 /*
  * Wow!  Someone wants to start up Lynx.
  */
@@ -1642,6 +1944,7 @@ int main(int argc,
      */
     if (!LYGetStdinArgs
 	&& !startfile_stdin
+	&& (dump_batch_file == NULL || strcmp(dump_batch_file, "-"))
 	&& !isatty(fileno(stdin))
 	&& (isatty(fileno(stdout) || isatty(fileno(stderr))))) {
 	int ignored = 0;
@@ -1724,6 +2027,11 @@ int main(int argc,
     if (LYCookieSaveFile != NULL) {
 	LYTildeExpand(&LYCookieSaveFile, FALSE);
     }
+
+    /* tilde-expand LYVisitedLinksFile */
+    if (LYVisitedLinksFile != NULL) {
+	LYTildeExpand(&LYVisitedLinksFile, FALSE);
+    }
 #ifdef USE_PROGRAM_DIR
     if (is_url(helpfile) == 0) {
 	char *tmp = NULL;
@@ -2140,34 +2448,38 @@ int main(int argc,
 	if (dump_output_width > 0) {
 	    LYcols = dump_output_width;
 	}
-	/*
-	 * Normal argument processing puts non-options (URLs) into the Goto
-	 * history.  Use this to dump all of the pages listed on the command
-	 * line, or (if none are listed) via the startfile mechanism.
-	 * history.
-	 */
+	if (dump_batch_file != NULL) {
+	    status = dump_batch(dump_batch_file);
+	} else {
+	    /*
+	     * Normal argument processing puts non-options (URLs) into the Goto
+	     * history.  Use this to dump all of the pages listed on the command
+	     * line, or (if none are listed) via the startfile mechanism.
+	     * history.
+	     */
 #ifdef EXTENDED_STARTFILE_RECALL
-	HTAddGotoURL(startfile);
-	for (i = HTList_count(Goto_URLs) - 1; i >= 0; --i) {
-	    StrAllocCopy(startfile, (char *) HTList_objectAt(Goto_URLs, i));
-	    CTRACE((tfp, "dumping %d:%d %s\n",
-		    i + 1, HTList_count(Goto_URLs), startfile));
+	    HTAddGotoURL(startfile);
+	    for (i = HTList_count(Goto_URLs) - 1; i >= 0; --i) {
+		StrAllocCopy(startfile, (char *) HTList_objectAt(Goto_URLs, i));
+		CTRACE((tfp, "dumping %d:%d %s\n",
+			i + 1, HTList_count(Goto_URLs), startfile));
+		status = mainloop();
+		if (!no_list &&
+		    !dump_links_inline &&
+		    !crawl)		/* For -crawl it has already been done! */
+		    printlist(stdout, FALSE);
+		if (i != 0)
+		    printf("\n");
+	    }
+#else
 	    status = mainloop();
 	    if (!no_list &&
 		!dump_links_inline &&
-		!crawl)		/* For -crawl it has already been done! */
+		!crawl &&		/* For -crawl it has already been done! */
+		links_are_numbered())
 		printlist(stdout, FALSE);
-	    if (i != 0)
-		printf("\n");
-	}
-#else
-	status = mainloop();
-	if (!no_list &&
-	    !dump_links_inline &&
-	    !crawl &&		/* For -crawl it has already been done! */
-	    links_are_numbered())
-	    printlist(stdout, FALSE);
 #endif
+	}
 #ifdef USE_PERSISTENT_COOKIES
 	/*
 	 * We want to save cookies picked up when in immediate dump mode.
@@ -2176,6 +2488,8 @@ int main(int argc,
 	if (persistent_cookies)
 	    LYStoreCookies(LYCookieSaveFile);
 #endif /* USE_PERSISTENT_COOKIES */
+	HTShowTimings();
+	LYShowMemoryStats();
 	exit_immediately(status);
     } else {
 	/*
@@ -2211,6 +2525,8 @@ int main(int argc,
 	}
 #endif
 	cleanup();
+	HTShowTimings();
+	LYShowMemoryStats();
 	exit_immediately(status);
     }
 
@@ -2530,6 +2846,14 @@ static int auth_fun(char *next_arg)
     return 0;
 }
 
+/* -batch */
+static int batch_fun(char *next_arg)
+{
+    force_dump_mode();
+    StrAllocCopy(dump_batch_file, next_arg);
+    return 0;
+}
+
 /* -base */
 static int base_fun(char *next_arg GCC_UNUSED)
 {
@@ -3335,6 +3659,17 @@ static Config_Type Arg_Table [] =
       "auth",		4|NEED_FUNCTION_ARG,	auth_fun,
       "=id:pw\nauthentication information for protected documents"
    ),
+   PARSE_FUN(
+      "batch",		1|NEED_FUNCTION_ARG,	batch_fun,
+      "=FILENAME\ndump each URL listed in FILENAME (\"-\" for stdin),\n\
+one per line, optionally followed by a file for its output"
+   ),
+#ifdef USE_BATCH_JOBS
+   PARSE_INT(
+      "batch_jobs",	4|NEED_INT_ARG,		dump_batch_jobs,
+      "=N\nwith -batch, dump up to N URLs at once in separate processes"
+   ),
+#endif
    PARSE_FUN(
       "base",		4|FUNCTION_ARG,		base_fun,
       "prepend a request URL comment and BASE tag to text/html\n\
@@ -3614,6 +3949,10 @@ soon as they are seen)"
       "=FILENAME\nspecifies a lynx.lss file other than the default"
    ),
 #endif
+   PARSE_SET(
+      "memstats",	4|SET_ARG,		show_memstats,
+      "report the memory used by documents, anchors,\ncaches and cookies"
+   ),
    PARSE_FUN(
       "mime_header",	4|FUNCTION_ARG,		mime_header_fun,
       "include mime headers and force source dump"
@@ -3935,6 +4274,10 @@ bug which treated '>' as a co-terminator for\ndouble-quotes and tags"
       "=NUMBER\nset TCP/IP timeout"
    ),
 #endif
+   PARSE_SET(
+      "timing",		4|SET_ARG,		show_timings,
+      "report the time spent in each phase of\nloading documents"
+   ),
    PARSE_SET(
       "tlog",		2|TOGGLE_ARG,		LYUseTraceLog,
       "toggles use of a Lynx Trace Log for the current\nsession"
@@ -11,6 +11,7 @@
 #include <HTTP.h>
 #include <HTAABrow.h>
 #include <HTNews.h>
+#include <HTTCP.h>
 #include <LYCurses.h>
 #include <LYStyle.h>
 #include <LYGlobalDefs.h>
@@ -943,6 +944,8 @@ static int DoTraversal(int c,
 		    (nhist <= 0)) {
 		    if (!dump_output_immediately) {
 			cleanup();
+			HTShowTimings();
+			LYShowMemoryStats();
 			exit_immediately(EXIT_FAILURE);
 		    }
 		    c = -1;
@@ -973,6 +976,8 @@ static int DoTraversal(int c,
 		(nhist <= 0)) {
 		if (!dump_output_immediately) {
 		    cleanup();
+		    HTShowTimings();
+		    LYShowMemoryStats();
 		    exit_immediately(EXIT_FAILURE);
 		}
 		c = -1;
@@ -3290,6 +3295,8 @@ static BOOLEAN handle_LYK_IMAGE_TOGGLE(int *cmd)
 
     HTUserMsg(clickable_images ?
 	      CLICKABLE_IMAGES_ON : CLICKABLE_IMAGES_OFF);
+    if (!HText_usesImageSettings(HTMainText))
+	return FALSE;		/* nothing would change */
     return reparse_or_reload(cmd);
 }
 
@@ -3448,6 +3455,8 @@ static BOOLEAN handle_LYK_INLINE_TOGGLE(int *cmd)
 
     HTUserMsg(pseudo_inline_alts ?
 	      PSEUDO_INLINE_ALTS_ON : PSEUDO_INLINE_ALTS_OFF);
+    if (!HText_usesImageSettings(HTMainText))
+	return FALSE;		/* nothing would change */
     return reparse_or_reload(cmd);
 }
 
@@ -5471,6 +5480,42 @@ static BOOLEAN handle_LYK_MAXSCREEN_TOGGLE(int *cmd)
 }
 #endif
 
+#ifdef NSL_FORK
+/*
+ * Start looking up the host of an http or https URL which the user may load
+ * next, unless it would be reached through a proxy.
+ */
+static void prefetch_host(char *address)
+{
+    int type;
+
+    if (isEmpty(address))
+	return;
+    if ((type = is_url(address)) == HTTP_URL_TYPE) {
+	if (LYGetEnv("http_proxy") == NULL || override_proxy(address))
+	    HTPrefetchHost(address, 80);
+    } else if (type == HTTPS_URL_TYPE) {
+	if (LYGetEnv("https_proxy") == NULL || override_proxy(address))
+	    HTPrefetchHost(address, 443);
+    }
+}
+
+/*
+ * While waiting for a keystroke, look up the hosts of the current link and
+ * of the document's LINK REL="Next", so that following either does not wait
+ * for the name server.
+ */
+static void prefetch_hosts(DocInfo *doc)
+{
+    if (!LYPrefetchHosts || local_host_only)
+	return;
+    if (doc->link >= 0 && doc->link < nlinks &&
+	links[doc->link].type == WWW_LINK_TYPE)
+	prefetch_host(links[doc->link].lname);
+    prefetch_host(HText_getNextLink());
+}
+#endif /* NSL_FORK */
+
 #ifdef LY_FIND_LEAKS
 #define CleanupMainLoop() \
  	BStrFree(prev_target); \
@@ -5532,6 +5577,10 @@ int mainloop(void)
     int tmpNewline;
     DocInfo tmpDocInfo;
 
+#ifdef LY_FIND_LEAKS
+    static BOOLEAN first_call = TRUE;
+#endif
+
     /* "internal" means "within the same document, with certainty".  It includes a
      * space so it cannot conflict with any (valid) "TYPE" attributes on A
      * elements.  [According to which DTD, anyway??] - kw
@@ -5550,22 +5599,14 @@ int mainloop(void)
      * newdoc.title   contains the link name that the user last chose to get
      *                into the current link (file).
      */
-    /* initialize some variables */
-    newdoc.address = NULL;
-    newdoc.title = NULL;
-    newdoc.post_data = NULL;
-    newdoc.post_content_type = NULL;
-    newdoc.bookmark = NULL;
+    /* initialize some variables (freeing any left from a previous dump) */
+    LYFreeDocInfo(&newdoc);
     newdoc.internal_link = FALSE;
-    curdoc.address = NULL;
-    curdoc.title = NULL;
-    curdoc.post_data = NULL;
-    curdoc.post_content_type = NULL;
-    curdoc.bookmark = NULL;
+    LYFreeDocInfo(&curdoc);
     curdoc.internal_link = FALSE;
 #ifdef USE_COLOR_STYLE
-    curdoc.style = NULL;
-    newdoc.style = NULL;
+    FREE(curdoc.style);
+    FREE(newdoc.style);
 #endif
 #ifndef USE_SESSIONS
     nhist = 0;
@@ -5573,7 +5614,10 @@ int mainloop(void)
     BStrCopy0(user_input_buffer, "");
     BStrCopy0(prev_target, "");
 #ifdef LY_FIND_LEAKS
-    atexit(free_mainloop_variables);
+    if (first_call) {
+	first_call = FALSE;
+	atexit(free_mainloop_variables);
+    }
 #endif
   initialize:
     set_address(&newdoc, startfile);
@@ -6018,6 +6062,14 @@ int mainloop(void)
 			newdoc.safe = FALSE;
 			newdoc.internal_link = FALSE;
 			goto try_again;
+		    } else if (dump_batch_file != NULL &&
+			       HTOutputFormat != WWW_PRESENT) {
+			/*
+			 * With -batch, -source output goes directly to stdout
+			 * rather than to HTMainText.
+			 */
+			CleanupMainLoop();
+			return (EXIT_SUCCESS);
 		    } else {
 			CleanupMainLoop();
 			exit_immediately_with_error_message(NULLFILE, first_file);
@@ -6988,6 +7040,9 @@ int mainloop(void)
 		    }
 		}
 #endif /* TEXTFIELDS_MAY_NEED_ACTIVATION && INACTIVE_INPUT_STYLE_VH */
+#ifdef NSL_FORK
+		prefetch_hosts(&curdoc);
+#endif
 		/*
 		 * Get a keystroke from the user.  Save the last keystroke to
 		 * avoid redundant error reporting.
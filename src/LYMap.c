@@ -82,17 +82,15 @@ void ImageMapList_free(HTList *theList)
     return;
 }
 
-#ifdef LY_FIND_LEAKS
 /*
  * Utility for freeing the global list of MAPs.  - kw
  */
-static void LYLynxMaps_free(void)
+void LYLynxMaps_free(void)
 {
     ImageMapList_free(LynxMaps);
     LynxMaps = NULL;
     return;
 }
-#endif /* LY_FIND_LEAKS */
 
 /*
  * We keep two kinds of lists:
@@ -15,6 +15,7 @@ extern "C" {
     extern BOOL LYMapsOnly;
 
     extern void ImageMapList_free(HTList *list);
+    extern void LYLynxMaps_free(void);
     extern void LYPrintImgMaps(FILE *fp);
     extern BOOL LYAddImageMap(char *address, char *title,
 			      HTParentAnchor *node_anchor);
@@ -2431,6 +2431,9 @@ static OptValues encoding_values[] =
 #endif
 #if defined(USE_BZLIB) || defined(BZIP2_PATH)
     {encodingBZIP2, N_("bzip2"), "encoding_bzip2"},
+#endif
+#if defined(USE_ZSTD) || defined(ZSTD_PATH)
+    {encodingZSTD, N_("zstd"), "encoding_zstd"},
 #endif
     {encodingALL, N_("All"), "encoding_all"},
     {0, 0, 0}
@@ -1667,6 +1667,9 @@ static Config_Type Config_Table [] =
      PARSE_ENU(RC_PREFERRED_ENCODING,   LYAcceptEncoding, tbl_preferred_encoding),
      PARSE_STR(RC_PREFERRED_LANGUAGE,   language),
      PARSE_ENU(RC_PREFERRED_MEDIA_TYPES, LYAcceptMedia, tbl_preferred_media),
+#ifdef NSL_FORK
+     PARSE_SET(RC_PREFETCH_HOSTS,       LYPrefetchHosts),
+#endif
      PARSE_SET(RC_PREPEND_BASE_TO_SOURCE, LYPrependBaseToSource),
      PARSE_SET(RC_PREPEND_CHARSET_TO_SOURCE, LYPrependCharsetToSource),
 #ifdef USE_PRETTYSRC
@@ -1771,6 +1774,7 @@ static Config_Type Config_Table [] =
      PARSE_SET(RC_VERBOSE_IMAGES,       verbose_img),
      PARSE_SET(RC_VI_KEYS_ALWAYS_ON,    vi_keys),
      PARSE_FUN(RC_VIEWER,               viewer_fun),
+     PARSE_STR(RC_VISITED_LINKS_FILE,   LYVisitedLinksFile),
      PARSE_Env(RC_WAIS_PROXY,           0),
      PARSE_SET(RC_WAIT_VIEWER_TERMINATION, wait_viewer_termination),
      PARSE_SET(RC_WITH_BACKSPACES,      with_backspaces),
@@ -1778,6 +1782,7 @@ static Config_Type Config_Table [] =
      PARSE_SET(RC_XHTML_PARSING,        LYxhtml_parsing),
      PARSE_PRG(RC_ZCAT_PATH,            ppZCAT),
      PARSE_PRG(RC_ZIP_PATH,             ppZIP),
+     PARSE_PRG(RC_ZSTD_PATH,            ppZSTD),
 
      PARSE_NIL
 };
@@ -106,6 +106,109 @@ static void dt_Number(FILE *fp0,
     FREE(buffer);
 }
 
+/*
+ * Show how long the document took to load, and where the time went.
+ */
+static void dt_Timings(FILE *fp0, HTParentAnchor *anchor)
+{
+    char *value = NULL;
+    const char *sep = " (";
+    int n;
+
+    if (anchor == NULL || anchor->timings[tpTotal] <= 0.0)
+	return;
+
+    HTSprintf(&value, "%.3f %s", anchor->timings[tpTotal], gettext("sec"));
+    for (n = 0; n < (int) tpTotal; ++n) {
+	if (anchor->timings[n] >= 0.0005) {
+	    HTSprintf(&value, "%s%s %.3f", sep,
+		      HTTimePhaseName((HTTimePhase) n),
+		      anchor->timings[n]);
+	    sep = ", ";
+	}
+    }
+    if (*sep == ',')
+	StrAllocCat(value, ")");
+    ADD_SS(gettext("Load time:"), value);
+    FREE(value);
+}
+
+static void dt_Memory(FILE *fp0,
+		      const char *label,
+		      long count,
+		      const char *units,
+		      long bytes)
+{
+    char *value = NULL;
+
+    HTSprintf0(&value, "%ld %s, %ld %s", count, units, bytes, gettext("bytes"));
+    ADD_SS(label, value);
+    FREE(value);
+}
+
+static void dt_AllMemory(FILE *fp0)
+{
+    long count;
+    long bytes;
+
+    bytes = HText_cacheMemory(&count);
+    dt_Memory(fp0, gettext("Documents:"), count, gettext("cached"), bytes);
+    bytes = HTAnchor_memoryUsed(&count);
+    dt_Memory(fp0, gettext("Anchors:"), count, gettext("addresses"), bytes);
+#ifdef USE_SOURCE_CACHE
+    bytes = HTAnchor_sourceCacheMemory(&count);
+    dt_Memory(fp0, gettext("Sources:"), count, gettext("cached"), bytes);
+#endif
+    bytes = LYCookieMemory(&count);
+    dt_Memory(fp0, gettext("Cookies:"), count, gettext("cookies"), bytes);
+}
+
+/*
+ * With -memstats, write the memory used by a document to stderr, if curses is
+ * not in use.
+ */
+void LYShowDocumentMemory(HTParentAnchor *anchor)
+{
+    long pools;
+    long bytes;
+
+    if (show_memstats && !LYCursesON && anchor != NULL) {
+	bytes = HText_memoryUsed((HText *) HTAnchor_document(anchor), &pools);
+	fflush(stdout);
+	fprintf(stderr, "memstats: document_bytes=%ld pools=%ld", bytes, pools);
+#ifdef USE_SOURCE_CACHE
+	fprintf(stderr, " source_bytes=%ld", HTAnchor_sourceMemory(anchor));
+#endif
+	fprintf(stderr, " url=%s\n", anchor->address);
+	fflush(stderr);
+    }
+}
+
+/*
+ * With -memstats, summarize the memory used by each subsystem when exiting.
+ */
+void LYShowMemoryStats(void)
+{
+    long count;
+    long bytes;
+
+    if (show_memstats) {
+	fflush(stdout);
+	bytes = HText_cacheMemory(&count);
+	fprintf(stderr, "memstats: documents=%ld document_bytes=%ld",
+		count, bytes);
+	bytes = HTAnchor_memoryUsed(&count);
+	fprintf(stderr, " anchors=%ld anchor_bytes=%ld", count, bytes);
+#ifdef USE_SOURCE_CACHE
+	bytes = HTAnchor_sourceCacheMemory(&count);
+	fprintf(stderr, " sources=%ld source_bytes=%ld", count, bytes);
+#endif
+	bytes = LYCookieMemory(&count);
+	fprintf(stderr, " cookies=%ld cookie_bytes=%ld\n", count, bytes);
+	fflush(stderr);
+    }
+}
+
 static void dt_URL(FILE *fp0, const char *address)
 {
     ADD_SS(gettext("URL:"), address);
@@ -372,6 +475,15 @@ int LYShowInfo(DocInfo *doc,
 	if ((cp = HText_getLastModified()) != NULL && *cp != '\0')
 	    ADD_SS(gettext("Last Mod:"), cp);
 
+	dt_Timings(fp0, HTMainAnchor);
+
+	{
+	    long pools;
+	    long bytes = HText_memoryUsed(HTMainText, &pools);
+
+	    dt_Memory(fp0, gettext("Memory:"), pools, gettext("pools"), bytes);
+	}
+
 #ifdef ADVANCED_INFO
 	if (LYInfoAdvanced) {
 	    if (HTMainAnchor && HTMainAnchor->expires) {
@@ -478,6 +590,10 @@ int LYShowInfo(DocInfo *doc,
 				  gettext("No Links on the current page")));
 	}
 
+	BEGIN_DL(gettext("Memory in use"));
+	dt_AllMemory(fp0);
+	END_DL();
+
 #ifdef EXP_HTTP_HEADERS
 	if ((cp = HText_getHttpHeaders()) != 0) {
 	    fprintf(fp0, "<h2>%s</h2>",
@@ -14,6 +14,8 @@ extern "C" {
     extern int LYShowInfo(DocInfo *doc,
 			  DocInfo *newdoc,
 			  char *owner_address);
+    extern void LYShowDocumentMemory(HTParentAnchor *anchor);
+    extern void LYShowMemoryStats(void);
 
 #ifdef __cplusplus
 }
@@ -4363,13 +4363,13 @@ int LYhandlePopupList(int cur_choice,
   redraw:
 
     /*
-     * Display the boxed choices.
+     * Display the boxed choices, i.e., only those which fit in the window.
      */
-    for (i = 0; i <= num_choices; i++) {
-	if (i >= window_offset && i - window_offset < length) {
-	    draw_option(form_window, ((i + 1) - window_offset), width, FALSE,
-			max_choices, i, choices[i]);
-	}
+    for (i = window_offset;
+	 i <= num_choices && i - window_offset < length;
+	 i++) {
+	draw_option(form_window, ((i + 1) - window_offset), width, FALSE,
+		    max_choices, i, choices[i]);
     }
     LYbox(form_window, !numbered);
     Cptr = NULL;
@@ -82,6 +82,8 @@ extern "C" {
 	struct _VisitedLink *prev_latest;
 	struct _VisitedLink *next_latest;
 	struct _VisitedLink *prev_first;
+	struct _VisitedLink *next_hash;
+	BOOLEAN saved;		/* ...in VISITED_LINKS_FILE */
     } VisitedLink;
 
     extern HistInfo *history;
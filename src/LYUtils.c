@@ -377,11 +377,21 @@ size_t utf8_length(int utf_flag,
 	     */
 	    utf_extra = 0;
 	}
-	if (strlen(data + 1) < utf_extra) {
+	if (utf_extra) {
+	    size_t n;
+
 	    /*
-	     * Shouldn't happen.
+	     * Check only the bytes we need, rather than the whole string.
 	     */
-	    utf_extra = 0;
+	    for (n = 1; n <= utf_extra; ++n) {
+		if (data[n] == '\0') {
+		    /*
+		     * Shouldn't happen.
+		     */
+		    utf_extra = 0;
+		    break;
+		}
+	    }
 	}
     }
     return utf_extra;
@@ -1703,7 +1713,6 @@ int LYReopenInput(void)
 }
 #endif
 
-#if defined(NSL_FORK) || defined(MISC_EXP) || defined (TTY_DEVICE) || defined(HAVE_TTYNAME)
 /*
  * Returns the file descriptor from which keyboard input is expected, or INVSOC
  * (-1) if not available.  If need_selectable is true, returns non-INVSOC fd
@@ -1737,7 +1746,6 @@ int LYConsoleInputFD(int need_selectable)
     }
     return fd;
 }
-#endif /* NSL_FORK || MISC_EXP */
 
 static int fake_zap = 0;
 
@@ -1758,22 +1766,33 @@ void LYFakeZap(int set)
 
 }
 
-static int DontCheck(void)
+/*
+ * Returns true if HTCheckForInterrupt() may read the keyboard, i.e., if it is
+ * worth waiting for a keystroke while waiting for the network.
+ */
+int LYCanCheckForInterrupt(void)
 {
-    static time_t last;
-    time_t next;
-
     /** Curses or slang setup was not invoked **/
     if (dump_output_immediately)
-	return (TRUE);
+	return (FALSE);
 
     if (LYHaveCmdScript())	/* we may be running from a script */
-	return (TRUE);
+	return (FALSE);
 
 #ifdef MISC_EXP
     if (LYNoZapKey)
-	return (TRUE);
+	return (FALSE);
 #endif
+    return (TRUE);
+}
+
+static int DontCheck(void)
+{
+    static time_t last;
+    time_t next;
+
+    if (!LYCanCheckForInterrupt())
+	return (TRUE);
     /*
      * Avoid checking interrupts more than one per second, since it is a slow
      * and expensive operation - TD
@@ -7096,6 +7115,44 @@ void LYAddHtmlSep0(char *path)
     }
 }
 
+#ifdef HAVE_COPY_FILE_RANGE
+/*
+ * Let the kernel copy the file, without reading it into our buffers.  Returns
+ * 1 if the whole file was copied, 0 if the rest must be copied by reading and
+ * writing, or -1 on error.  That is the case if the filesystems do not support
+ * this, or if less than the file's size was copied, e.g., from procfs, which
+ * reports no data for files that are not empty.
+ */
+static int kernel_copy(FILE *fin, FILE *fout)
+{
+    int fd_in = fileno(fin);
+    int fd_out = fileno(fout);
+    struct stat stat_in;
+    off_t total = 0;
+    ssize_t len;
+
+    if (fstat(fd_in, &stat_in) != 0
+	|| !S_ISREG(stat_in.st_mode))
+	return 0;
+
+    while ((len = copy_file_range(fd_in, NULL, fd_out, NULL,
+				  (size_t) (1 << 30), 0)) != 0) {
+	if (len < 0) {
+	    if (errno == EINTR)
+		continue;
+	    if (total == 0 && (errno == EXDEV
+			       || errno == ENOSYS
+			       || errno == EINVAL
+			       || errno == EOPNOTSUPP))
+		return 0;
+	    return -1;
+	}
+	total += len;
+    }
+    return (total == 0 || total < stat_in.st_size) ? 0 : 1;
+}
+#endif /* HAVE_COPY_FILE_RANGE */
+
 /*
  * Copy a file
  */
@@ -7123,18 +7180,26 @@ int LYCopyFile(char *src,
 	FILE *fin, *fout;
 	unsigned char buff[BUFSIZ];
 	size_t len;
+#ifdef HAVE_COPY_FILE_RANGE
+	int copied;
+#endif
 
 	code = EOF;
 	if ((fin = fopen(src, BIN_R)) != 0) {
 	    if ((fout = fopen(dst, BIN_W)) != 0) {
 		code = 0;
-		while ((len = fread(buff, (size_t) 1, sizeof(buff), fin)) != 0) {
-		    if (fwrite(buff, (size_t) 1, len, fout) < len
-			|| ferror(fout)) {
-			code = EOF;
-			break;
+#ifdef HAVE_COPY_FILE_RANGE
+		if ((copied = kernel_copy(fin, fout)) < 0)
+		    code = EOF;
+		else if (copied == 0)
+#endif
+		    while ((len = fread(buff, (size_t) 1, sizeof(buff), fin)) != 0) {
+			if (fwrite(buff, (size_t) 1, len, fout) < len
+			    || ferror(fout)) {
+			    code = EOF;
+			    break;
+			}
 		    }
-		}
 		LYCloseOutput(fout);
 	    }
 	    LYCloseInput(fin);
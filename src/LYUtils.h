@@ -165,6 +165,7 @@ extern "C" {
     extern const char *index_to_restriction(unsigned inx);
     extern const char *wwwName(const char *pathname);
     extern int HTCheckForInterrupt(void);
+    extern int LYCanCheckForInterrupt(void);
     extern int LYConsoleInputFD(int need_selectable);
     extern int LYCopyFile(char *src, char *dst);
     extern int LYGetHilitePos(int cur, int count);
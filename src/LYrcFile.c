@@ -96,6 +96,9 @@ Config_Enum tbl_preferred_encoding[] = {
 #endif
 #if defined(USE_BZLIB) || defined(BZIP2_PATH)
     { "bzip2",		encodingBZIP2 },
+#endif
+#if defined(USE_ZSTD) || defined(ZSTD_PATH)
+    { "zstd",		encodingZSTD },
 #endif
     { "all",		encodingALL },
     { NULL,		-1 }
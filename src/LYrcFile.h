@@ -190,6 +190,7 @@
 #define RC_PREFERRED_ENCODING           "preferred_encoding"
 #define RC_PREFERRED_LANGUAGE           "preferred_language"
 #define RC_PREFERRED_MEDIA_TYPES        "preferred_media_types"
+#define RC_PREFETCH_HOSTS               "prefetch_hosts"
 #define RC_PREPEND_BASE_TO_SOURCE       "prepend_base_to_source"
 #define RC_PREPEND_CHARSET_TO_SOURCE    "prepend_charset_to_source"
 #define RC_PRETTYSRC                    "prettysrc"
@@ -273,6 +274,7 @@
 #define RC_VERBOSE_IMAGES               "verbose_images"
 #define RC_VIEWER                       "viewer"
 #define RC_VISITED_LINKS                "visited_links"
+#define RC_VISITED_LINKS_FILE           "visited_links_file"
 #define RC_VI_KEYS                      "vi_keys"
 #define RC_VI_KEYS_ALWAYS_ON            "vi_keys_always_on"
 #define RC_WAIS_PROXY                   "wais_proxy"
@@ -282,6 +284,7 @@
 #define RC_XLOADIMAGE_COMMAND           "xloadimage_command"
 #define RC_ZCAT_PATH                    "zcat_path"
 #define RC_ZIP_PATH                     "zip_path"
+#define RC_ZSTD_PATH                    "zstd_path"
 
 extern Config_Enum tbl_force_prompt[];
 extern Config_Enum tbl_keypad_mode[];
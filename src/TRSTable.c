@@ -25,9 +25,9 @@
 #endif
 
 #ifdef USE_CURSES_PADS
-#  define MAX_STBL_POS (LYwideLines ? MAX_COLS - 1 : LYcolLimit)
+#  define MAX_STBL_POS ((LYwideLines || Stbl_wrapCells()) ? MAX_COLS - 1 : LYcolLimit)
 #else
-#  define MAX_STBL_POS (LYcolLimit)
+#  define MAX_STBL_POS (Stbl_wrapCells() ? MAX_COLS - 1 : LYcolLimit)
 #endif
 
 /* must be different from HT_ALIGN_NONE and HT_LEFT, HT_CENTER etc.: */
@@ -150,6 +150,7 @@ struct _STable_info {
     short rowgroup_align;	/* align default for current group of rows */
     short pending_colgroup_align;
     int pending_colgroup_next;
+    int last_row;		/* where find_row found the last row */
     STable_states s;
 };
 
@@ -186,11 +187,17 @@ struct _STable_info {
  *    as if they were not part of the cell and row.  This allows us to
  *    cooperate with one way in which tables have been made friendly to
  *    browsers without any table support.
+ *  - Tables wider than display, when dumping.  The rows are not wrapped while
+ *    we collect them, and GridText.c wraps the cells into narrower columns
+ *    when the table is finished, using Stbl_getRowCells and
+ *    Stbl_getColumnPos.  That works only for tables whose rows are each on
+ *    a single line.
  *  Missing, but can be added:
  *  - Support for COLGROUP/COL
- *  - Tables wider than display.  The limitation is not here but in GridText.c
- *    etc.  If horizontal scrolling were implemented there, the mechanisms
- *    here coudl deal with wide tables (just change MAX_STBL_POS code).
+ *  - Tables wider than display, when not dumping.  The limitation is not
+ *    here but in GridText.c etc.  If horizontal scrolling were implemented
+ *    there, the mechanisms here coudl deal with wide tables (just change
+ *    MAX_STBL_POS code).
  *  Missing, unlikely to add:
  *  - Support for non-LTR directionality.  A general problem, support is
  *    lacking throughout the lynx code.
@@ -1948,27 +1955,93 @@ static int get_fixup_positions(STable_rowinfo *me, int *oldpos,
  *	    0 or greater (number of oldpos/newpos pairs) if we have
  *	      a table row.
  */
+/*
+ * Return the row which is on the given line, or null if there is none.
+ */
+static STable_rowinfo *find_row(STable_info *me, int lineno)
+{
+    int j;
+
+    /*
+     * Rows are in order of their lines, and callers ask for the lines in
+     * order, so we usually need look no further than the last row found.
+     */
+    j = me->last_row;
+    if (j <= 0 || j >= me->nrows || me->rows[j].Line >= lineno)
+	j = 0;
+    for (; j < me->nrows; j++) {
+	if (me->rows[j].Line == lineno) {
+	    me->last_row = j;
+	    return me->rows + j;
+	}
+    }
+    return NULL;
+}
+
 int Stbl_getFixupPositions(STable_info *me, int lineno,
 			   int *oldpos,
 			   int *newpos)
 {
     STable_rowinfo *row;
-    int j;
     int ninserts = -1;
 
     if (!me || !me->nrows)
 	return -1;
-    for (j = 0; j < me->nrows; j++) {
-	row = me->rows + j;
-	if (row->Line == lineno) {
-	    ninserts = get_fixup_positions(row, oldpos, newpos,
-					   me->sumcols);
-	    break;
-	}
-    }
+    if ((row = find_row(me, lineno)) != NULL)
+	ninserts = get_fixup_positions(row, oldpos, newpos,
+				       me->sumcols);
     return ninserts;
 }
 
+/*
+ * Returns the position where the given column starts, or -1 if there is no
+ * such column.  Only valid after Stbl_finishTABLE.
+ */
+int Stbl_getColumnPos(STable_info *me, int icol)
+{
+    if (!me || icol < 0 || icol > me->ncols || icol >= me->allocated_sumcols)
+	return -1;
+    return me->sumcols[icol].pos;
+}
+
+/*
+ * Describe the cells of the row on the given line, so they can be wrapped
+ * into narrower columns.  For each cell which has content, store the column
+ * where it starts, the number of columns it spans, and its alignment.
+ *
+ * Returns -1 if we have no row for this lineno, or if the row continues a
+ * cell from a previous line, or has a cell which begins on another line,
+ *	    0 or greater (number of cells) otherwise.
+ */
+int Stbl_getRowCells(STable_info *me, int lineno,
+		     int *cols,
+		     int *spans,
+		     int *aligns)
+{
+    STable_rowinfo *row;
+    int i;
+    int ncells = 0;
+
+    if (!me || !me->nrows)
+	return -1;
+    row = find_row(me, lineno);
+    if (row == NULL
+	|| (row->content & (IS_CONTINUATION_OF_CELL | OFFSET_IS_VALID)))
+	return -1;
+    for (i = 0; i < row->ncells; i += HTMAX(1, row->cells[i].colspan)) {
+	if (row->cells[i].alignment == RESERVEDCELL
+	    || row->cells[i].cLine < 0)
+	    continue;		/* nothing to wrap */
+	if (row->cells[i].cLine != lineno)
+	    return -1;
+	cols[ncells] = i;
+	spans[ncells] = HTMIN(HTMAX(1, row->cells[i].colspan), me->ncols - i);
+	aligns[ncells] = row->cells[i].alignment;
+	ncells++;
+    }
+    return ncells;
+}
+
 int Stbl_getStartLine(STable_info *me)
 {
     if (!me)
@@ -30,6 +30,21 @@ extern "C" {
 				      int *oldpos,
 				      int *newpos);
     extern short Stbl_getAlignment(STable_info *);
+    extern int Stbl_getColumnPos(STable_info *me, int icol);
+    extern int Stbl_getRowCells(STable_info *me, int lineno,
+				int *cols,
+				int *spans,
+				int *aligns);
+
+/*
+ * When dumping, rows are collected without wrapping them at the screen width,
+ * and GridText.c wraps the cells of tables which are too wide when they end.
+ */
+#ifdef EXP_NESTED_TABLES
+#define Stbl_wrapCells() (dump_output_immediately && !nested_tables)
+#else
+#define Stbl_wrapCells() (dump_output_immediately)
+#endif
 
 #ifdef EXP_NESTED_TABLES
     extern void Stbl_update_enclosing(STable_info *me, int max_width,
@@ -624,6 +624,54 @@ UCode_t UCGetUniFromUtf8String(const char **ppuni)
     return uc_out;
 }
 
+/*
+ * Word-at-a-time tests for bytes in an unsigned long (see "Bit Twiddling
+ * Hacks").  The "less" test is exact only for bytes without the high bit,
+ * which are checked separately.
+ */
+#define ONES_BYTES	((unsigned long) ~0UL / 255)
+#define HIGH_BYTES	(ONES_BYTES * 0x80)
+#define HasZeroByte(x)	(((x) - ONES_BYTES) & ~(x) & HIGH_BYTES)
+#define HasLessByte(x,n) (((x) - ONES_BYTES * (n)) & ~(x) & HIGH_BYTES)
+#define HasThisByte(x,n) HasZeroByte((x) ^ (ONES_BYTES * (unsigned long)(n)))
+
+#define IsPlainByte(c,stop1,stop2) \
+	((c) >= 0x20 && (c) < 0x7f && (c) != (stop1) && (c) != (stop2))
+
+#define IsPlainWord(w,stop1,stop2) \
+	!(((w) & HIGH_BYTES) \
+	  | HasLessByte(w, 0x20) \
+	  | HasThisByte(w, 0x7f) \
+	  | HasThisByte(w, stop1) \
+	  | HasThisByte(w, stop2))
+
+/*
+ * Return the length of the leading run of printable ASCII characters in the
+ * buffer, i.e., those which need no translation from UTF-8 or most 8-bit
+ * charsets, and use one cell each.  The run also stops at the two given
+ * characters (use 0 if not needed).  This checks a word at a time, two words
+ * per iteration, so long runs of plain text go quickly.
+ */
+size_t UCAsciiSpan(const char *s, size_t len, int stop1, int stop2)
+{
+    size_t n = 0;
+
+#ifndef EBCDIC
+    unsigned long w1, w2;
+
+    while (n + 2 * sizeof(w1) <= len) {
+	memcpy(&w1, s + n, sizeof(w1));
+	memcpy(&w2, s + n + sizeof(w1), sizeof(w2));
+	if (!(IsPlainWord(w1, stop1, stop2) && IsPlainWord(w2, stop1, stop2)))
+	    break;
+	n += 2 * sizeof(w1);
+    }
+    while (n < len && IsPlainByte(UCH(s[n]), stop1, stop2))
+	++n;
+#endif
+    return n;
+}
+
 /*
  * Combine UTF-8 into Unicode.  Incomplete characters are either ignored, or
  * returned as the UCS replacement character.
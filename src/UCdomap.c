@@ -832,11 +832,90 @@ static void UCconsole_map_init(void)
     UCInitialized = 1;
 }
 
+/*
+ * The translation functions below are called for each character of a
+ * document.  Their results depend only on the parameters, so they are cached
+ * in direct-mapped tables which are filled on first use:
+ *
+ *	UCTransChar	256 entries per (charset_in, charset_out)
+ *	UCTransToUni	256 entries per charset_in (not stateful ones)
+ *	UCTransUniChar	pages of 256 entries per charset_out, for the BMP
+ */
+#define UC_PAGE_BITS	8
+#define UC_PAGE_SIZE	(1 << UC_PAGE_BITS)
+#define UC_PAGE_COUNT	(0x10000 >> UC_PAGE_BITS)
+
+typedef short UCTransPage[UC_PAGE_SIZE];
+
+static UCTransPage **trans_char_cache;	/* [MAXCHARSETS * MAXCHARSETS] */
+static UCode_t **trans_to_uni_cache;	/* [MAXCHARSETS] */
+static UCTransPage **trans_uni_cache;	/* [MAXCHARSETS * UC_PAGE_COUNT] */
+
+#define ValidCacheIndex(n) ((n) >= 0 && (n) < MAXCHARSETS)
+
+/*
+ * Discard the cached translations, e.g., when a charset is (re)defined.
+ */
+static void UCclear_trans_cache(void)
+{
+    int n;
+
+    if (trans_char_cache != 0) {
+	for (n = 0; n < MAXCHARSETS * MAXCHARSETS; ++n)
+	    FREE(trans_char_cache[n]);
+	FREE(trans_char_cache);
+    }
+    if (trans_to_uni_cache != 0) {
+	for (n = 0; n < MAXCHARSETS; ++n)
+	    FREE(trans_to_uni_cache[n]);
+	FREE(trans_to_uni_cache);
+    }
+    if (trans_uni_cache != 0) {
+	for (n = 0; n < MAXCHARSETS * UC_PAGE_COUNT; ++n)
+	    FREE(trans_uni_cache[n]);
+	FREE(trans_uni_cache);
+    }
+}
+
+static int trans_uni_char(UCode_t unicode, int charset_out);
+static int trans_char(int ch_in, int charset_in, int charset_out);
+static UCode_t trans_to_uni(int ch_in, int charset_in);
+
 /*
  * OK now, finally, some stuff that is more specifically for Lynx:  - KW
  */
 int UCTransUniChar(UCode_t unicode,
 		   int charset_out)
+{
+    UCTransPage *page;
+    int n;
+
+    if (unicode < 0
+	|| unicode > 0xffff
+	|| !ValidCacheIndex(charset_out))
+	return trans_uni_char(unicode, charset_out);
+
+    if (trans_uni_cache == 0) {
+	trans_uni_cache = typecallocn(UCTransPage *, MAXCHARSETS * UC_PAGE_COUNT);
+	if (trans_uni_cache == 0)
+	    outofmem(__FILE__, "UCTransUniChar");
+    }
+    n = (charset_out * UC_PAGE_COUNT) + (int) (unicode >> UC_PAGE_BITS);
+    if ((page = trans_uni_cache[n]) == 0) {
+	UCode_t base = unicode & ~(UCode_t) (UC_PAGE_SIZE - 1);
+
+	if ((page = typeMalloc(UCTransPage)) == 0)
+	    outofmem(__FILE__, "UCTransUniChar");
+	for (n = 0; n < UC_PAGE_SIZE; ++n)
+	    (*page)[n] = (short) trans_uni_char(base + n, charset_out);
+	trans_uni_cache[(charset_out * UC_PAGE_COUNT)
+			+ (int) (unicode >> UC_PAGE_BITS)] = page;
+    }
+    return (*page)[unicode & (UC_PAGE_SIZE - 1)];
+}
+
+static int trans_uni_char(UCode_t unicode,
+			  int charset_out)
 {
     int rc = 0;
     int UChndl_out;
@@ -1082,6 +1161,33 @@ static int UC_MapGN(int UChndl,
 int UCTransChar(int ch_in,
 		int charset_in,
 		int charset_out)
+{
+    UCTransPage *page;
+    int n;
+
+    if (charset_in == charset_out)
+	return UCH(ch_in);
+    if (!ValidCacheIndex(charset_in) || !ValidCacheIndex(charset_out))
+	return trans_char(ch_in, charset_in, charset_out);
+
+    if (trans_char_cache == 0) {
+	trans_char_cache = typecallocn(UCTransPage *, MAXCHARSETS * MAXCHARSETS);
+	if (trans_char_cache == 0)
+	    outofmem(__FILE__, "UCTransChar");
+    }
+    if ((page = trans_char_cache[(charset_in * MAXCHARSETS) + charset_out]) == 0) {
+	if ((page = typeMalloc(UCTransPage)) == 0)
+	    outofmem(__FILE__, "UCTransChar");
+	for (n = 0; n < UC_PAGE_SIZE; ++n)
+	    (*page)[n] = (short) trans_char(n, charset_in, charset_out);
+	trans_char_cache[(charset_in * MAXCHARSETS) + charset_out] = page;
+    }
+    return (*page)[UCH(ch_in)];
+}
+
+static int trans_char(int ch_in,
+		      int charset_in,
+		      int charset_out)
 {
     UCode_t unicode;
     int Gn;
@@ -1179,6 +1285,41 @@ UCode_t UCTransJPToUni(char *inbuf,
  */
 UCode_t UCTransToUni(int ch_in,
 		     int charset_in)
+{
+    UCode_t *table;
+    int n;
+
+    if (charset_in < 0
+	|| charset_in == UTF8_handle
+	|| !ValidCacheIndex(charset_in))
+	return trans_to_uni(ch_in, charset_in);
+
+    if (trans_to_uni_cache != 0
+	&& (table = trans_to_uni_cache[charset_in]) != 0)
+	return table[UCH(ch_in)];
+
+#ifdef EXP_JAPANESEUTF8_SUPPORT
+    if ((strcmp(LYCharSet_UC[charset_in].MIMEname, "shift_jis") == 0) ||
+	(strcmp(LYCharSet_UC[charset_in].MIMEname, "euc-jp") == 0)) {
+	return trans_to_uni(ch_in, charset_in);
+    }
+#endif
+
+    if (trans_to_uni_cache == 0) {
+	trans_to_uni_cache = typecallocn(UCode_t *, MAXCHARSETS);
+	if (trans_to_uni_cache == 0)
+	    outofmem(__FILE__, "UCTransToUni");
+    }
+    if ((table = typecallocn(UCode_t, UC_PAGE_SIZE)) == 0)
+	outofmem(__FILE__, "UCTransToUni");
+    for (n = 0; n < UC_PAGE_SIZE; ++n)
+	table[n] = trans_to_uni(n, charset_in);
+    trans_to_uni_cache[charset_in] = table;
+    return table[UCH(ch_in)];
+}
+
+static UCode_t trans_to_uni(int ch_in,
+			    int charset_in)
 {
     static char buffer[10];
     static unsigned inx = 0;
@@ -1868,6 +2009,7 @@ static int UC_Register_with_LYCharSets(int s,
     int i, LYhndl, found;
     STRING2PTR repl;
 
+    UCclear_trans_cache();
     LYhndl = -1;
     if (LYNumCharsets == 0) {
 	/*
@@ -2029,6 +2171,7 @@ static int UC_NoUctb_Register_with_LYCharSets(const char *UC_MIMEcharset,
 {
     int i, LYhndl = -1;
 
+    UCclear_trans_cache();
     if (LYNumCharsets == 0) {
 	/*
 	 * Initialize here; so whoever changes
@@ -2126,6 +2269,7 @@ static void UCcleanup_mem(void)
     int i;
 
     UCfree_allocated_LYCharSets();
+    UCclear_trans_cache();
     con_clear_unimap_str(0);
     con_clear_unimap_str(1);
     con_clear_unimap(0);